@@ -65,12 +65,211 @@
 	Getstat/Setstat codes that are possible with PIC firmware revision 1.x
 	are appropriate marked.
 
+	The driver derives its capabilities from the firmware revision once at
+	init. The #F14BC_CAPS Getstat returns them together with the supervised
+	voltage channels (nominal voltage set), so applications can skip
+	unsupported functions and channels without calling the driver.
+
 	When the first path is opened to an F14BC device, the HW and the driver are being
 	initialized with default values	(see section about \ref descriptor_entries).
 
+	To keep the device open fast (e.g. for watchdog services at boot), the
+	driver reads the PIC firmware revision only when an F14BC is opened for
+	the first time since the driver was loaded and caches it per SMB bus and
+	address (see FWREV_CACHE descriptor key). With block reads, the
+	revision is read with one I2C transfer. A reopen of a PIC with firmware
+	rev. 2.0 or later then only reads the watchdog state, which also checks
+	the device access. The cached revision is dropped after #F14BC_SWRESET
+	and when the device fails at init. Revisions of the first
+	firmware are not cached.
+
+    \n \subsection locking Locking
+	The driver doesn't require MDIS call locking (LL_LOCK_NONE). It locks
+	the SMBus only for the duration of each SMBus transaction, so Getstats
+	that are served from driver memory (e.g. #F14BC_VOLT_SVSTATE,
+	#F14BC_BLK_FWREV, snapshot values) never wait and a #WDOG_TRIG waits
+	at most for one pending SMBus transaction of another call. Setstats
+	other than #WDOG_TRIG and #F14BC_WDOG_ALIVE are serialized by the
+	driver. The driver's alarm never waits for the SMBus, it repeats a
+	poll or watchdog auto-kick that found the SMBus busy with its next
+	period.
+
+	Callers waiting for the SMBus are queued per access class. Watchdog
+	operations (#WDOG_TRIG, #WDOG_START, #WDOG_STOP, #WDOG_TIME) are
+	served before all other calls, so the trigger latency doesn't depend
+	on the monitoring load. The #F14BC_BLK_BUSQ_STAT Getstat returns the
+	number of transactions, the queue depth and the wait times of each
+	class (see \ref busq_classes), #F14BC_BUSQ_CLR clears them.\n
+
+    \n \subsection xferstat SMBus statistics
+	The driver counts all SMBus transactions with the F14BC per SMB command
+	and the failed transactions per SMB2 error code. It also records the
+	transaction times in a log2 histogram of OSS ticks. The resolution is
+	one tick (F14BC_XFER_STAT.tickRate, e.g. 1ms at 1000 ticks/s), so with
+	a coarse tick most transactions are counted in the first bin (<1 tick).
+	The #F14BC_BLK_XFER_STAT Getstat returns these statistics, e.g. to choose
+	the POLL_PERIOD or to detect SMBus contention with other SMB2 clients,
+	#F14BC_XFER_STAT_CLR clears them. SMB2 errors are returned in the device
+	specific error code range (ERR_DEV + SMB2 error code).\n
+
+    \n \subsection retries SMBus retries and circuit breaker
+	An SMBus transaction that fails with a transient SMB2 error (bus busy,
+	collision e.g. due to arbitration loss, no acknowledge) is repeated up
+	to XFER_RETRY times. The delay before each retry starts with
+	XFER_BACKOFF, doubles with each retry and has a random jitter. The
+	driver's alarm doesn't retry, it polls again with its next period and
+	counts failed polls (#F14BC_POLL_FAIL).
+
+	After BREAKER_LIMIT consecutive failed transactions, the driver assumes
+	that the PIC is not responding: The circuit breaker opens and all calls
+	that access the SMBus fail immediately with F14BC_ERR_NORESP instead of
+	waiting for the SMBus timeout. Every BREAKER_TIMEOUT, one call probes
+	the PIC and closes the breaker on success. Watchdog operations always
+	access the SMBus. #F14BC_BREAKER gets or closes the breaker, the
+	#F14BC_BLK_XFER_STAT Getstat also returns the number of retries and
+	breaker trips.\n
+
+    \n \subsection coalescing Watchdog trigger coalescing
+	If several threads trigger the watchdog, most #WDOG_TRIG calls are
+	redundant. If the WDOG_COALESCE descriptor key is set, the driver skips
+	a trigger if the last trigger was sent less than WDOG_COALESCE percent
+	of the watchdog time (the window) ago. Skipped triggers are
+	acknowledged without SMBus access and counted (#F14BC_WDOG_TRIGSKIP).
+
+	A skipped trigger relies on the next #WDOG_TRIG call. The driver takes
+	the interval since the previous call as the time of the next call and
+	skips only if that call still comes at least the window before the
+	watchdog expires. Calls with an interval of the watchdog time minus
+	the window or more are never skipped. So coalescing is safe
+	as long as the interval between two calls doesn't grow by more than
+	the window from one call to the next.
+	With PIC firmware revision 1.x, coalescing starts after the watchdog
+	time was set with #WDOG_TIME.\n
+
+    \n \subsection autokick Watchdog auto-kick
+	In auto-kick mode (#F14BC_WDOG_AUTO), the driver's alarm triggers the
+	running watchdog every third of the watchdog time, so the SMBus timing no longer
+	depends on the scheduling of the application. Instead, each application
+	thread registers a liveness token with a deadline (#F14BC_WDOG_TOKEN) and
+	refreshes it regularly with #F14BC_WDOG_ALIVE, which doesn't access the
+	SMBus. The driver stops triggering the watchdog if no token is
+	registered or any registered token was not refreshed within its
+	deadline. The watchdog must still be started with #WDOG_START. With PIC
+	firmware revision 1.x, the watchdog time must be set with #WDOG_TIME
+	first.\n
+
     \n \subsection channels Logical channels
 	The driver provides seven logical channels that relates to the supervised
-	voltages of the F14BC. All other functionality is channel independent.\n
+	voltages of the F14BC. All other functionality is channel independent.
+
+	The nominal and deviation voltages are configuration values of the
+	PIC. The driver reads them only once on first use and serves all further
+	#F14BC_VOLT_NOM, #F14BC_VOLT_DEV and #F14BC_BLK_VOLT_ALL requests from
+	its cache.\n
+
+	The windows can be changed with the #F14BC_VOLT_NOM and #F14BC_VOLT_DEV
+	Setstats for the current channel or with the #F14BC_BLK_VOLT_CFG Setstat
+	for all channels at once. The block Setstat checks all values first,
+	writes only the registers that differ from the cache and reads both
+	register ranges back to verify them (ERR_LL_WRITE on mismatch). Values
+	must be multiples of 25mV. A setting of 0 disables the supervision of a
+	channel.\n
+
+    \n \subsection blockread Block reads
+	The #F14BC_BLK_VOLT_ALL Getstat returns the input, nominal and deviation
+	voltages of all channels with one call, the #F14BC_BLK_ERRCNT_ALL
+	Getstat returns all error counters with one call. If the BLOCK_READ descriptor key
+	is set, the driver reads each range of consecutive F14BC registers with
+	a single I2C transfer instead of one SMBus command per register. This
+	requires a firmware that increments the register address on reads and
+	an SMB controller with I2C support.\n
+
+	Any other combination of Getstats can be done with one #F14BC_BLK_MULTI
+	call. It takes an array of F14BC_MULTI requests (code and channel),
+	performs them in order and returns the value and error code of each
+	request. It replaces the M_MK_CH_CURRENT Setstat and Getstat pairs of
+	a channel loop. Block codes are rejected with ERR_LL_ILL_PARAM.\n
+
+    \n \subsection svevents Supervision events
+	The driver's alarm polls the voltage supervision state of the F14BC every
+	POLL_PERIOD while a signal is installed (#F14BC_VOLT_SIGSET), the poll
+	is enabled with #F14BC_VOLT_POLL or the snapshot mode is enabled. Each
+	change of the state is recorded with a timestamp in an event ring of
+	the driver. The application gets and removes all pending events
+	(F14BC_SVEVENT structures) with one #F14BC_BLK_SVEVENTS Getstat or
+	with M_getblock(). If the ring is full, new events are dropped and
+	counted (#F14BC_SVEVT_LOST).
+
+	If #F14BC_SVEVT_TOUT is set, the poll is enabled and M_getblock()
+	waits up to this timeout until events are recorded and then returns
+	all pending events at once. On timeout, M_getblock() returns 0 bytes.
+	The wait holds no driver lock, so a thread can wait for events
+	without signal handling and without polling #F14BC_VOLT_SVSTATE,
+	while other threads use the device. Only one thread should wait.
+
+	The polled state is debounced per voltage with the SV_DEBOUNCE and
+	SV_HYSTERESIS descriptor keys before it is evaluated. By default, the
+	signal is sent on each poll with a voltage out of range and
+	#F14BC_VOLT_SVSTATE returns the last out of range state. If SIG_EDGE
+	is set, the signal is sent only when the state changes and
+	#F14BC_VOLT_SVSTATE returns the current state. #F14BC_VOLT_SVCUR
+	always returns the current state of the poll.
+
+	If POLL_PERIOD_MIN and POLL_PERIOD_MAX differ, the poll period is
+	adaptive: As long as all voltages are in range and their deviation from
+	the nominal voltage is below 75% of the allowed deviation, the period is
+	doubled with each poll up to POLL_PERIOD_MAX. Otherwise, the driver
+	switches to POLL_PERIOD_MIN. The effective period is always a multiple
+	of POLL_PERIOD_MIN and can be queried with #F14BC_POLL_PERIOD.\n
+
+    \n \subsection warnings Software warning thresholds
+	In addition to the supervision of the F14BC firmware, the driver can
+	compare the input voltages with software thresholds that are typically
+	tighter than the firmware limits. The thresholds are set per channel
+	with #F14BC_VOLT_WARN_LO and #F14BC_VOLT_WARN_HI. While a threshold is
+	set, the voltage supervision is polled and the driver reads the input
+	voltages of all channels and records each change of the warning state
+	(#F14BC_VOLT_WARNSTATE) as #F14BC_SVEVT_WARN event. If a signal is
+	installed, it is sent on each change of the warning state.\n
+
+    \n \subsection history Voltage history
+	If the HISTORY_SIZE descriptor key is set, the driver stores the input
+	voltages of all channels of the last HISTORY_SIZE polls in a history
+	buffer (the voltage supervision is then always polled). The #F14BC_BLK_VOLT_HIST Getstat returns the min., max. and mean
+	input voltage of each channel over this window, so an application that
+	samples rarely still sees short peaks. #F14BC_VOLT_HIST_CLR restarts
+	the window.\n
+
+    \n \subsection snapshot Snapshot mode
+	By default, each voltage and error counter Getstat reads the
+	corresponding register of the F14BC via SMBus. If the SNAPSHOT_MODE
+	descriptor key is set, the driver's alarm reads the input voltages,
+	error counters and supervision state every POLL_PERIOD into a snapshot and the Getstats return the values
+	from the snapshot without any SMBus access. The age of the snapshot
+	can be queried with #F14BC_SNAP_AGE.\n
+
+    \n \subsection multictrl Additional controllers
+	One driver instance can supervise further F14BC compatible controllers,
+	e.g. the board controllers of other boards in the same chassis. They
+	are specified with the CTRL_NUMBER descriptor key and the
+	CTRL_n/SMB_BUSNBR and CTRL_n/SMB_DEVADDR keys (n=1..CTRL_NUMBER), the
+	controllers may be on different SMBusses.
+
+	With every supervision poll, the driver's alarm sweeps over all
+	controllers and reads their input voltages, error counters and
+	supervision state in one pass. The #F14BC_BLK_CTRL_SNAP Getstat
+	returns the results of the last sweep for all controllers at once
+	(index 0: this F14BC). The entry of this F14BC is taken from the
+	registers the supervision poll reads anyway, so the sweep only adds
+	the SMBus transactions of the additional controllers. A controller
+	that could not be read keeps its last values and reports the error.
+	If the SMBus was busy, the whole entry is kept and no error is
+	reported, the next poll reads it again. The driver must be able to access
+	all controllers at init time.
+
+	Supervision events, signals and all other Getstat/Setstat codes refer
+	to this F14BC only. The SMBus retries and the circuit breaker don't
+	apply to the additional controllers.\n
 
     \n \section api_functions Supported API Functions
 
@@ -88,6 +287,8 @@
     <td>F14BC_SetStat()</td></tr>
     <tr><td>M_getstat()   </td><td>Get device parameter     </td>
     <td>F14BC_GetStat()</td></tr>
+    <tr><td>M_getblock()  </td><td>Get supervision events   </td>
+    <td>F14BC_BlockRead()</td></tr>
     <tr><td>M_errstringTs() </td><td>Generate error message </td>
     <td>-</td></tr>
     </table>
@@ -118,6 +319,109 @@
         <td>50..5000ms\n
 			Default: 500ms</td>
     </tr>
+    <tr><td>BLOCK_READ</td>
+        <td>Read consecutive F14BC registers with one I2C transfer\n
+		    (requires an SMB controller with I2C support)</td>
+        <td>0 = off, 1 = on\n
+			Default: 0</td>
+    </tr>
+    <tr><td>POLL_PERIOD_MIN</td>
+        <td>Poll period for voltage supervision if a voltage is out of range
+		    or near its limits (adaptive poll period)</td>
+        <td>50..5000ms or 0 (= POLL_PERIOD)\n
+			Default: 0</td>
+    </tr>
+    <tr><td>POLL_PERIOD_MAX</td>
+        <td>Max. poll period for voltage supervision if all voltages are
+		    in range (adaptive poll period)</td>
+        <td>POLL_PERIOD_MIN..5000ms or 0 (= POLL_PERIOD)\n
+			Default: 0</td>
+    </tr>
+    <tr><td>WDOG_COALESCE</td>
+        <td>Watchdog trigger coalescing window in percent of the
+		    watchdog time\n
+		    (the interval between two #WDOG_TRIG calls must not grow by
+		    more than the window)</td>
+        <td>0..50%, 0 = off\n
+			Default: 0</td>
+    </tr>
+    <tr><td>XFER_RETRY</td>
+        <td>Max. number of retries of an SMBus transaction that failed
+		    with a transient error</td>
+        <td>0..10\n
+			Default: 2</td>
+    </tr>
+    <tr><td>XFER_BACKOFF</td>
+        <td>Delay before the first retry (doubled with each retry,
+		    plus random jitter)</td>
+        <td>1..100ms\n
+			Default: 2ms</td>
+    </tr>
+    <tr><td>BREAKER_LIMIT</td>
+        <td>Number of consecutive failed SMBus transactions that open
+		    the circuit breaker</td>
+        <td>0..255, 0 = no circuit breaker\n
+			Default: 8</td>
+    </tr>
+    <tr><td>BREAKER_TIMEOUT</td>
+        <td>Time between two probes of the PIC while the circuit breaker
+		    is open</td>
+        <td>10..60000ms\n
+			Default: 1000ms</td>
+    </tr>
+    <tr><td>SIG_EDGE</td>
+        <td>Send the supervision signal only on state changes\n
+		    (only for FW-Rev. 2.0 and later)</td>
+        <td>0 = on each out of range poll, 1 = on changes\n
+			Default: 0</td>
+    </tr>
+    <tr><td>SV_DEBOUNCE</td>
+        <td>Number of consecutive out of range polls until a voltage
+		    is considered out of range</td>
+        <td>1..255\n
+			Default: 1</td>
+    </tr>
+    <tr><td>SV_HYSTERESIS</td>
+        <td>Number of consecutive in range polls until a voltage
+		    is considered in range again</td>
+        <td>1..255\n
+			Default: 1</td>
+    </tr>
+    <tr><td>HISTORY_SIZE</td>
+        <td>Number of polled input voltage samples in the voltage history</td>
+        <td>0..4096, 0 = no history\n
+			Default: 0</td>
+    </tr>
+    <tr><td>FWREV_CACHE</td>
+        <td>Use the firmware revision read at a previous open of the
+		    same F14BC (SMB bus and address)</td>
+        <td>0 = always read, 1 = use cache\n
+			Default: 1</td>
+    </tr>
+    <tr><td>SNAPSHOT_MODE</td>
+        <td>Serve voltage and error counter Getstats from a register
+		    snapshot that is refreshed every POLL_PERIOD\n
+		    (only for FW-Rev. 2.0 and later)</td>
+        <td>0 = off, 1 = on\n
+			Default: 0</td>
+    </tr>
+    <tr><td>CTRL_NUMBER</td>
+        <td>Number of additional controllers to supervise\n
+		    (only for FW-Rev. 2.0 and later)</td>
+        <td>0..8\n
+			Default: 0</td>
+    </tr>
+    <tr><td>CTRL_n/SMB_BUSNBR</td>
+        <td>SMBus bus number of additional controller n
+		    (n=1..CTRL_NUMBER)</td>
+        <td>0, 1, 2, ...\n
+			Default: -</td>
+    </tr>
+    <tr><td>CTRL_n/SMB_DEVADDR</td>
+        <td>SMBus address of additional controller n</td>
+        <td>0x00, 0xff\n
+			Default: -</td>
+    </tr>
     </tr>
     </table>
 
@@ -140,6 +444,48 @@
     \subsection f14bc_ctrl  Tool that controls the F14BC PIC (example of using the F14BC driver)
     f14bc_ctrl.c (see Examples section)
 
+    With option -t=<ms>, f14bc_ctrl keeps the path open and writes a
+    record with all input voltages, the supervision state and all error
+    counters every <ms> to stdout, as CSV lines or, with option -j, as
+    JSON lines. Each record is read with one #F14BC_BLK_MULTI getstat and
+    carries the monotonic time since stream start. Option -n=<nbr> stops
+    the stream after <nbr> records. The poll (#F14BC_VOLT_POLL) is enabled
+    while streaming and the supervision state is the current state of the
+    poll (#F14BC_VOLT_SVCUR).
+
+    With option -x=<file>, f14bc_ctrl keeps the path open and exports
+    the input, nominal and deviation voltages, the supervision and
+    warning state, the error counters, the firmware revision and the
+    watchdog state as Prometheus metrics to the textfile <file> (e.g.
+    for the textfile collector of the node exporter). The metrics are
+    refreshed every -t=<ms> (default 1000ms). Each refresh is written to
+    <file>.tmp and renamed to <file>, so a scrape always reads a complete
+    refresh and never waits for the SMBus. The poll (#F14BC_VOLT_POLL) is
+    enabled while exporting and the current supervision state
+    (#F14BC_VOLT_SVCUR) is exported. The device label value is escaped
+    as required by the Prometheus text format.
+
+    \subsection f14bc_bench  Host benchmark of the F14BC driver
+    f14bc_bench.c runs the driver against a simulated F14BC (f14bc_sim.c)
+    without MDIS kernel and hardware. It reports the host time, SMBus
+    transactions and simulated bus time per Getstat/Setstat and the
+    watchdog trigger latency under supervision load. The simulated bus
+    latency and fault injection are set with command line options.
+
+    \subsection f14bc_ctrl_bench  Transaction count benchmark of f14bc_ctrl
+    f14bc_ctrl_bench.c runs each f14bc_ctrl mode (-v, -e, -f, -c, -t)
+    against the driver and the simulated F14BC and reports the SMBus
+    transactions, MDIS calls and host time per tool run. It fails if a
+    count exceeds the budget of the mode, so that a driver or tool change
+    which adds bus transactions is noticed.
+
+    Both benchmarks are host programs: They include the driver source and
+    provide their own stand-ins for OSS, DESC, SMB2 and the MDIS API, so
+    they are not part of the MDIS package build. Each is built with the
+    Makefile next to its sources, e.g.
+    make MEN_INC_DIR=<MDIS>/INCLUDE/COM MEN_LIB_DIR=<dir of host usr_oss,
+    usr_utl>.
+
     \subsection wdog_test  Tool to service and test the watchdog
     wdog_test.c (see example section)
 
@@ -54,15 +54,71 @@
 +-----------------------------------------*/
 /* general defines */
 #define CH_NUMBER			F14BCI_VOLT_NBR	/**< Number of device channels */
+#define ERRCNT_NUMBER		F14BCI_ERRCNT_NBR	/**< Number of error counters */
 #define CH_BYTES			4			/**< Number of bytes per channel */
 #define USE_IRQ				FALSE		/**< Interrupt required  */
 #define ADDRSPACE_COUNT		0			/**< Number of required address spaces */
 #define ADDRSPACE_SIZE		0			/**< Size of address space */
+#define POLL_NEAR_PCT		75			/**< voltage deviation [% of allowed]
+											 that switches to fast polling */
+#define WDTOKEN_NBR			8			/**< Number of watchdog liveness tokens */
+#define HIST_SIZE_MAX		4096		/**< Max. voltage history samples */
+#define SVEVT_RING_SIZE		32			/**< Number of supervision events
+											 in ring (power of 2) */
+#define FWREV_CACHE_NBR		8			/**< Number of cached firmware revs */
+#define CTRL_MAX			8			/**< Max. additional controllers
+											 (F14BC_CTRL_MAX) */
 
 /* debug defines */
 #define DBG_MYLEVEL			llHdl->dbgLevel   /**< Debug level */
 #define DBH					llHdl->dbgHdl     /**< Debug handle */
 
+/* supervision poll required? */
+#define SV_POLL_REQUIRED(h)	((h)->snapMode || (h)->svPoll || (h)->sigHdl || \
+							 (h)->ctrlNbr || (h)->svEvtTout || (h)->warnOn || \
+							 (h)->histSize)
+
+/* watchdog auto-kick period [ms] (a third of the watchdog time, so a kick
+   skipped due to a busy SMBus can be repeated in time) */
+#define WDOG_KICK_PERIOD(h)	(((h)->wdTime / 3) < 50 ? 50 : ((h)->wdTime / 3))
+
+/*
+ * block getstat/setstat code?
+ * mdis_api.h places the block codes of each code range in the page above
+ * its standard codes (M_xx_BLK_OF = M_xx_OF + 0x100, e.g. M_MK_BLK_OF,
+ * M_LL_BLK_OF, M_DEV_BLK_OF), so all odd pages hold block codes.
+ */
+#define CODE_IS_BLK(c)		((c) & (M_MK_BLK_OF - M_MK_OF))
+
+/* SMBus transactions (SmbXfer) */
+#define XFER_WR_BYTE		0	/**< write byte (command only) */
+#define XFER_WR_BYTE_DATA	1	/**< write byte data */
+#define XFER_RD_BYTE_DATA	2	/**< read byte data */
+#define XFER_WR_WORD_DATA	3	/**< write word data */
+#define XFER_RD_WORD_DATA	4	/**< read word data */
+#define XFER_RD_BLOCK		5	/**< I2C command write + n byte read */
+
+/* SMBus access classes in priority order (SmbXfer, see F14BC_BUSQ_xxx) */
+#define BUS_WDOG			0	/**< watchdog operations */
+#define BUS_CALL			1	/**< other driver calls */
+#define BUS_ALARM			2	/**< alarm handler (never waits) */
+#define BUS_CLASS_NBR		3	/**< number of access classes */
+
+/* SMBus transaction statistics (see F14BC_XFER_STAT) */
+#define XFER_CMD_NBR		256	/**< number of SMB command codes */
+#define XFER_ERR_NBR		16	/**< number of error counters */
+#define XFER_LAT_NBR		16	/**< number of latency histogram bins */
+#define XFER_DELAY_MAX		1000	/**< max. retry backoff [ms] */
+
+/* failed SMBus transaction (mapped SMB2 error)? */
+#define XFER_FAULT(e)		(((e) > ERR_DEV) && ((e) < ERR_DEV + SMB_ERR_LAST))
+
+/* transient SMBus error that is worth a retry? */
+#define XFER_TRANSIENT(e)	(((e) == ERR_DEV + SMB_ERR_BUSY) || \
+							 ((e) == ERR_DEV + SMB_ERR_COLL) || \
+							 ((e) == ERR_DEV + SMB_ERR_CTRL_BUSY) || \
+							 ((e) == ERR_DEV + SMB_ERR_NO_DEVICE))
+
 /* macro to map SMB2 error code into device specific error code range */
 #define SMB2_ERRMAP(err)	(((err) && ((err) < (SMB_ERR_LAST))) ? \
 								((err) += (ERR_DEV)) : (err))
@@ -70,6 +126,61 @@
 /*-----------------------------------------+
 |  TYPEDEFS                                |
 +-----------------------------------------*/
+/** register snapshot (refreshed by the alarm in snapshot mode) */
+typedef struct {
+	u_int8			voltIn[CH_NUMBER];	/**< F14BCI_VOLT_IN(c) */
+	u_int8			errCnt[ERRCNT_NUMBER];	/**< F14BCI_ERRCNT_xxx */
+	u_int8			svState;		/**< F14BCI_VOLT_SVSTATE */
+	u_int32			tick;			/**< OSS tick of refresh */
+} SNAPSHOT;
+
+/** poll sweep result of one controller (see CtrlSweep) */
+typedef struct {
+	u_int8			voltIn[CH_NUMBER];	/**< F14BCI_VOLT_IN(c) */
+	u_int8			errCnt[ERRCNT_NUMBER];	/**< F14BCI_ERRCNT_xxx */
+	u_int8			svState;		/**< F14BCI_VOLT_SVSTATE */
+	int32			error;			/**< error of last sweep */
+	u_int32			tick;			/**< OSS tick of last successful sweep */
+} CTRL_SWEEP;
+
+/** supervised controller (see CTRL_NUMBER) */
+typedef struct {
+	SMB_HANDLE		*smbH;			/**< ptr to SMB_HANDLE struct */
+	u_int32			busNbr;			/**< SMB bus number */
+	u_int16			smbAddr;		/**< SMB address */
+	u_int8			blkRead;		/**< use I2C multi-byte reads */
+	CTRL_SWEEP		sweep[2];		/**< sweep result double buffer */
+} CTRL_DEV;
+
+/** supervision event in ring (see F14BC_SVEVENT) */
+typedef struct {
+	u_int32			tick;			/**< OSS tick of event */
+	u_int8			type;			/**< F14BC_SVEVT_xxx */
+	u_int8			state;			/**< new state bitmask */
+} SVEVENT;
+
+/** cached firmware revision of one F14BC (see FwRevGet) */
+typedef struct {
+	volatile u_int8	valid;			/**< entry is used */
+	u_int32			busNbr;			/**< SMB bus number */
+	u_int16			smbAddr;		/**< SMB address of F14BC */
+	u_int8 fwRev[F14BCI_REV_BYTESIZE];	/**< PIC firmware revision */
+} FWREV_CACHE;
+
+/** SMBus queue of one access class (see F14BC_BUSQ_STAT) */
+typedef struct {
+	OSS_SEM_HANDLE	*grant;			/**< SMBus handover to a waiter */
+	u_int32			waiting;		/**< number of waiting callers */
+	u_int32			xfers;			/**< number of transactions */
+	u_int32			waits;			/**< transactions found SMBus busy */
+	u_int32			depthMax;		/**< max. number of waiting callers */
+	u_int32			waitMax;		/**< max. wait time [ms] */
+	u_int32			waitSum;		/**< sum of wait times [ms] */
+} BUSQ;
+
+/** firmware dependent handlers (see G_fwOps) */
+typedef struct FW_OPS FW_OPS;
+
 /** low-level handle */
 typedef struct {
 	/* general */
@@ -84,13 +195,98 @@ typedef struct {
 	/* f14bc specific */
 	SMB_HANDLE		*smbH;			/**< ptr to SMB_HANDLE struct */
 	u_int16			smbAddr;		/**< SMB address of F14BC */
+	OSS_SPINL_HANDLE *busLock;		/**< guards SMBus queue */
+	u_int8			busBusy;		/**< SMBus transaction in progress */
+	BUSQ			busq[BUS_CLASS_NBR];	/**< SMBus queue per class */
+	/* SMBus transaction statistics (modified by the SMBus owner only) */
+	u_int32			xferCmd[XFER_CMD_NBR];	/**< transactions per command */
+	u_int32			xferErr[XFER_ERR_NBR];	/**< errors per SMB2 error */
+	u_int32			xferLat[XFER_LAT_NBR];	/**< log2 latency histogram */
+	u_int32			xferTicks;		/**< sum of transaction times [ticks] */
+	/* retries and circuit breaker (guarded by busLock) */
+	u_int32			xferRetry;		/**< max. retries per transaction */
+	u_int32			xferBackoff;	/**< base retry backoff [ms] */
+	u_int32			xferRetries;	/**< number of retries */
+	u_int32			xferSeed;		/**< backoff jitter generator */
+	u_int32			brkLimit;		/**< consecutive faults to open (0=off) */
+	u_int32			brkTmo;			/**< time until next probe [ms] */
+	u_int32			brkFaults;		/**< consecutive faults */
+	u_int8			brkOpen;		/**< breaker is open */
+	u_int32			brkTick;		/**< OSS tick of open/last probe */
+	u_int32			brkTrips;		/**< number of breaker trips */
+	u_int32			pollFail;		/**< failed supervision polls */
+	OSS_SEM_HANDLE	*ctrlSem;		/**< serializes setstats and
+										 event ring consumers */
 	u_int8 fwRev[F14BCI_REV_BYTESIZE]; /**< PIC firmware revision */
-	u_int8			fwRevFirst;		/**< 1: first release of PIC firmware */
+	u_int32			caps;			/**< capabilities (F14BC_CAP_xxx) */
+	/* voltage configuration cache (nominal/deviation) */
+	OSS_SPINL_HANDLE *cfgLock;		/**< guards the cache */
+	u_int8			cfgNom[CH_NUMBER];	/**< F14BCI_VOLT_NOM(c) */
+	u_int8			cfgDev[CH_NUMBER];	/**< F14BCI_VOLT_DEV(c) */
+	u_int8			cfgValid;		/**< cfgNom/cfgDev are valid */
+	u_int32			cfgGen;			/**< cache generation (odd while
+										 CfgWrite() is running) */
+	const FW_OPS	*fwOps;			/**< handlers bound to firmware rev. */
 	u_int8			wdStatus;		/**< Watchdog status */
+	u_int32			wdTime;			/**< watchdog time [ms] (0=unknown) */
+	u_int32			wdCoalesce;		/**< coalescing window [% of wdTime] */
+	u_int8			wdTrigValid;	/**< wdTrigTick is valid */
+	u_int32			wdTrigTick;		/**< OSS tick of last sent trigger */
+	u_int32			wdTrigSkip;		/**< number of coalesced triggers */
+	u_int8			wdCallValid;	/**< wdCallTick is valid */
+	u_int32			wdCallTick;		/**< OSS tick of last WDOG_TRIG call */
+	u_int32			wdAuto;			/**< 1: alarm triggers the watchdog */
+	u_int32			wdKickElapsed;	/**< time since last auto trigger [ms] */
+	u_int8			wdKickPend;		/**< auto trigger pending (SMBus was busy,
+										 BusRelease sends it, busLock) */
+	u_int32			wdTokTmo[WDTOKEN_NBR];	/**< token deadline [ms], 0=unused */
+	volatile u_int32 wdTokTick[WDTOKEN_NBR];	/**< OSS tick of token refresh */
     OSS_SIG_HANDLE  *sigHdl;        /**< signal handle */
     OSS_ALARM_HANDLE *alarmHdl;		/**< alarm handle */
-	u_int32			pollPeriod;		/**< poll period for alarm [ms] */
+	u_int32			pollPeriod;		/**< current poll period [ms] */
+	u_int32			pollMin;		/**< min. (fast) poll period [ms] */
+	u_int32			pollMax;		/**< max. (slow) poll period [ms] */
+	u_int32			pollElapsed;	/**< time since last poll [ms] */
+	/* software voltage warning thresholds */
+	u_int32			warnLo[CH_NUMBER];	/**< low threshold [mV], 0=off */
+	u_int32			warnHi[CH_NUMBER];	/**< high threshold [mV], 0=off */
+	u_int8			warnOn;			/**< any threshold set */
+	u_int8			warnState;		/**< voltage warning state */
+	/* voltage history */
+	u_int32			histSize;		/**< samples in history (0=off) */
+	u_int8			*hist;			/**< history [histSize][CH_NUMBER] */
+	u_int32			histMem;		/**< allocated history size */
+	OSS_SPINL_HANDLE *histLock;		/**< guards the history */
+	u_int32			histCnt;		/**< samples written (alarm only) */
+	u_int32			histStart;		/**< histCnt at last clear */
 	u_int8			voltSvState;	/**< last voltage supervision state */
+	u_int8			alarmOn;		/**< alarm is running */
+	u_int32			alarmMs;		/**< alarm period [ms] */
+	u_int32			blkRead;		/**< 1: use I2C multi-byte reads */
+	/* snapshot mode */
+	u_int32			snapMode;		/**< 1: serve getstats from snapshot */
+	SNAPSHOT		snap[2];		/**< snapshot double buffer */
+	volatile u_int32 snapIdx;		/**< index of valid snapshot */
+	/* supervision events */
+	u_int32			svPoll;			/**< 1: poll without signal */
+	u_int8			svLast;			/**< last (filtered) supervision state */
+	u_int32			sigEdge;		/**< 1: signal only on state changes */
+	u_int32			svDebounce;		/**< polls until out of range is accepted */
+	u_int32			svHyst;			/**< polls until in range is accepted */
+	u_int8			svSetCnt[CH_NUMBER];	/**< out of range poll counters */
+	u_int8			svClrCnt[CH_NUMBER];	/**< in range poll counters */
+	u_int32			initTick;		/**< OSS tick of init (event time base) */
+	SVEVENT			svEvt[SVEVT_RING_SIZE];	/**< event ring */
+	OSS_SPINL_HANDLE *svEvtLock;	/**< guards the event ring */
+	u_int32			svEvtIn;		/**< ring write count (alarm only) */
+	u_int32			svEvtOut;		/**< ring read count (callers only) */
+	u_int32			svEvtLost;		/**< events lost due to full ring */
+	int32			svEvtTout;		/**< BlockRead timeout [ms] (0=no wait) */
+	OSS_SEM_HANDLE	*svEvtSem;		/**< signalled by SvEvtPut (if svEvtTout) */
+	/* supervised controllers ([0]: this F14BC, [n]: CTRL_n) */
+	u_int32			ctrlNbr;		/**< number of additional controllers */
+	CTRL_DEV		ctrl[1+CTRL_MAX];	/**< controllers */
+	volatile u_int32 ctrlIdx;		/**< index of valid sweep results */
 } LL_HANDLE;
 
 /* include files which need LL_HANDLE */
@@ -99,6 +295,20 @@ typedef struct {
 
 static const char IdentString[]=MENT_XSTR(MAK_REVISION);
 
+/* firmware revisions of the F14BCs opened since driver load */
+static FWREV_CACHE G_fwRevCache[FWREV_CACHE_NBR];
+
+/** firmware dependent handlers */
+struct FW_OPS {
+	int32 (*wdogStart)(LL_HANDLE *llHdl);	/**< start and verify WDOG */
+	int32 (*wdogStop)(LL_HANDLE *llHdl);	/**< stop and verify WDOG */
+	int32 (*swReset)(LL_HANDLE *llHdl);		/**< software reset */
+	int32 (*setStat)(LL_HANDLE *llHdl, int32 code, int32 ch,
+					 INT32_OR_64 value32_or_64);	/**< additional setstats */
+	int32 (*getStat)(LL_HANDLE *llHdl, int32 code, int32 ch,
+					 INT32_OR_64 *value32_or_64P);	/**< additional getstats */
+};
+
 /*-----------------------------------------+
 |  PROTOTYPES                              |
 +-----------------------------------------*/
@@ -124,6 +334,66 @@ static int32 Cleanup(LL_HANDLE *llHdl, int32 retCode);
 
 /* F14BC specific helper functions */
 static void AlarmHandler(void *arg);
+static int32 AlarmUpdate(LL_HANDLE *llHdl);
+static int32 FwRevGet(LL_HANDLE *llHdl, u_int32 useCache);
+static void FwRevCacheSet(LL_HANDLE *llHdl, u_int32 valid);
+static void CapsInit(LL_HANDLE *llHdl);
+static int32 WdogStartRev1(LL_HANDLE *llHdl);
+static int32 WdogStartRev2(LL_HANDLE *llHdl);
+static int32 WdogStopRev1(LL_HANDLE *llHdl);
+static int32 WdogStopRev2(LL_HANDLE *llHdl);
+static int32 SwResetRev1(LL_HANDLE *llHdl);
+static int32 SwResetRev2(LL_HANDLE *llHdl);
+static int32 SetStatRev1(LL_HANDLE *llHdl, int32 code, int32 ch,
+						 INT32_OR_64 value32_or_64);
+static int32 SetStatRev2(LL_HANDLE *llHdl, int32 code, int32 ch,
+						 INT32_OR_64 value32_or_64);
+static int32 GetStatRev1(LL_HANDLE *llHdl, int32 code, int32 ch,
+						 INT32_OR_64 *value32_or_64P);
+static int32 GetStatRev2(LL_HANDLE *llHdl, int32 code, int32 ch,
+						 INT32_OR_64 *value32_or_64P);
+
+/* handlers for firmware rev. 1.x / rev. 2.0 and later */
+static const FW_OPS G_fwOpsRev1 = { WdogStartRev1, WdogStopRev1, SwResetRev1,
+									SetStatRev1, GetStatRev1 };
+static const FW_OPS G_fwOpsRev2 = { WdogStartRev2, WdogStopRev2, SwResetRev2,
+									SetStatRev2, GetStatRev2 };
+static int32 SnapRefresh(LL_HANDLE *llHdl, u_int32 cls);
+static u_int8 *SnapReg(LL_HANDLE *llHdl, u_int8 cmd);
+static u_int8 *CfgReg(u_int8 *nom, u_int8 *dev, u_int8 cmd);
+static int32 CfgLoad(LL_HANDLE *llHdl, u_int32 cls, u_int8 *nom,
+					 u_int8 *dev);
+static int32 CfgWrite(LL_HANDLE *llHdl, u_int8 *nom, u_int8 *dev);
+static int32 CfgCheck(int32 mv);
+static int32 RegRead(LL_HANDLE *llHdl, u_int8 cmd, u_int8 *valP);
+static int32 RegReadBlk(LL_HANDLE *llHdl, u_int32 cls, u_int8 cmd,
+						u_int8 n, u_int8 *buf);
+static int32 SmbReadBlk(LL_HANDLE *llHdl, u_int32 cls, u_int8 cmd,
+						u_int8 n, u_int8 *buf);
+static int32 SmbXfer(LL_HANDLE *llHdl, u_int32 cls, u_int32 op, u_int8 cmd,
+					 void *data, u_int8 n);
+static int32 SmbXferOnce(LL_HANDLE *llHdl, u_int32 cls, SMB_HANDLE *smbH,
+						 u_int16 addr, u_int32 op, u_int8 cmd, void *data,
+						 u_int8 n);
+static int32 CtrlSweep(LL_HANDLE *llHdl, u_int32 cls, CTRL_SWEEP *own);
+static int32 CtrlReadBlk(LL_HANDLE *llHdl, u_int32 cls, CTRL_DEV *dev,
+						 u_int8 cmd, u_int8 n, u_int8 *buf);
+static u_int32 XferBackoff(LL_HANDLE *llHdl, u_int32 try);
+static int32 BreakerCheck(LL_HANDLE *llHdl);
+static void BreakerUpdate(LL_HANDLE *llHdl, int32 error);
+static int32 BusGet(LL_HANDLE *llHdl, u_int32 cls);
+static void BusRelease(LL_HANDLE *llHdl);
+static void WdogKickPending(LL_HANDLE *llHdl);
+static void XferStat(LL_HANDLE *llHdl, u_int8 cmd, int32 error,
+					 u_int32 ticks);
+static u_int32 TickToMs(LL_HANDLE *llHdl, u_int32 ticks);
+static u_int8 SvFilter(LL_HANDLE *llHdl, u_int8 raw);
+static void WdogAutoKick(LL_HANDLE *llHdl);
+static void PollAdapt(LL_HANDLE *llHdl, u_int8 state, u_int8 *in);
+static u_int8 WarnCheck(LL_HANDLE *llHdl, u_int8 *in);
+static void HistStat(LL_HANDLE *llHdl, F14BC_VOLT_STAT *stat);
+static void SvEvtPut(LL_HANDLE *llHdl, u_int8 type, u_int8 state);
+static int32 SvEvtGet(LL_HANDLE *llHdl, F14BC_SVEVENT *evt, int32 nbr);
 
 /****************************** F14BC_GetEntry ********************************/
 /** Initialize driver's jump table
@@ -178,8 +448,7 @@ static int32 F14BC_Init(
     LL_HANDLE	*llHdl = NULL;
     u_int32		gotsize, smbBusNbr;
     int32		error;
-    u_int32		value;
-	u_int8		n, tmp;
+    u_int32		value, cls, fwRevCache, n;
 
     /*------------------------------+
     |  prepare the handle           |
@@ -198,6 +467,8 @@ static int32 F14BC_Init(
     llHdl->memAlloc   = gotsize;
     llHdl->osHdl      = osHdl;
     llHdl->irqHdl     = irqHdl;
+    llHdl->initTick   = OSS_TickGet( osHdl );
+    llHdl->xferSeed   = llHdl->initTick ^ (u_int32)(U_INT32_OR_64)llHdl;
 
     /*------------------------------+
     |  init id function table       |
@@ -260,6 +531,171 @@ static int32 F14BC_Init(
 		(llHdl->pollPeriod > 5000))
 		return( Cleanup(llHdl,ERR_LL_DESC_PARAM) );
 
+    /* POLL_PERIOD_MIN [ms] */
+    if((error = DESC_GetUInt32(llHdl->descHdl, 0,
+								&llHdl->pollMin, "POLL_PERIOD_MIN")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
+		return( Cleanup(llHdl,error) );
+
+    /* POLL_PERIOD_MAX [ms] */
+    if((error = DESC_GetUInt32(llHdl->descHdl, 0,
+								&llHdl->pollMax, "POLL_PERIOD_MAX")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
+		return( Cleanup(llHdl,error) );
+
+	/* not specified: fixed POLL_PERIOD */
+	if( llHdl->pollMin == 0 )
+		llHdl->pollMin = llHdl->pollPeriod;
+	if( llHdl->pollMax == 0 )
+		llHdl->pollMax = llHdl->pollPeriod;
+	/* check range */
+	if( (llHdl->pollMin < 50) ||
+		(llHdl->pollMax > 5000) ||
+		(llHdl->pollMin > llHdl->pollMax) )
+		return( Cleanup(llHdl,ERR_LL_DESC_PARAM) );
+
+	/* start with POLL_PERIOD (multiple of alarm period) */
+	if( llHdl->pollPeriod < llHdl->pollMin )
+		llHdl->pollPeriod = llHdl->pollMin;
+	if( llHdl->pollPeriod > llHdl->pollMax )
+		llHdl->pollPeriod = llHdl->pollMax;
+	llHdl->pollPeriod -= llHdl->pollPeriod % llHdl->pollMin;
+
+    /* WDOG_COALESCE [%] */
+    if((error = DESC_GetUInt32(llHdl->descHdl, 0,
+								&llHdl->wdCoalesce, "WDOG_COALESCE")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
+		return( Cleanup(llHdl,error) );
+	/* check range */
+	if( llHdl->wdCoalesce > 50 )
+		return( Cleanup(llHdl,ERR_LL_DESC_PARAM) );
+
+    /* XFER_RETRY */
+    if((error = DESC_GetUInt32(llHdl->descHdl, 2,
+								&llHdl->xferRetry, "XFER_RETRY")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
+		return( Cleanup(llHdl,error) );
+
+    /* XFER_BACKOFF [ms] */
+    if((error = DESC_GetUInt32(llHdl->descHdl, 2,
+								&llHdl->xferBackoff, "XFER_BACKOFF")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
+		return( Cleanup(llHdl,error) );
+
+    /* BREAKER_LIMIT */
+    if((error = DESC_GetUInt32(llHdl->descHdl, 8,
+								&llHdl->brkLimit, "BREAKER_LIMIT")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
+		return( Cleanup(llHdl,error) );
+
+    /* BREAKER_TIMEOUT [ms] */
+    if((error = DESC_GetUInt32(llHdl->descHdl, 1000,
+								&llHdl->brkTmo, "BREAKER_TIMEOUT")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
+		return( Cleanup(llHdl,error) );
+	/* check range */
+	if( (llHdl->xferRetry > 10) ||
+		(llHdl->xferBackoff < 1) || (llHdl->xferBackoff > 100) ||
+		(llHdl->brkLimit > 255) ||
+		(llHdl->brkTmo < 10) || (llHdl->brkTmo > 60000) )
+		return( Cleanup(llHdl,ERR_LL_DESC_PARAM) );
+
+    /* SIG_EDGE */
+    if((error = DESC_GetUInt32(llHdl->descHdl, 0,
+								&llHdl->sigEdge, "SIG_EDGE")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
+		return( Cleanup(llHdl,error) );
+
+    /* SV_DEBOUNCE [polls] */
+    if((error = DESC_GetUInt32(llHdl->descHdl, 1,
+								&llHdl->svDebounce, "SV_DEBOUNCE")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
+		return( Cleanup(llHdl,error) );
+
+    /* SV_HYSTERESIS [polls] */
+    if((error = DESC_GetUInt32(llHdl->descHdl, 1,
+								&llHdl->svHyst, "SV_HYSTERESIS")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
+		return( Cleanup(llHdl,error) );
+	/* check range */
+	if( (llHdl->svDebounce < 1) || (llHdl->svDebounce > 255) ||
+		(llHdl->svHyst < 1) || (llHdl->svHyst > 255) )
+		return( Cleanup(llHdl,ERR_LL_DESC_PARAM) );
+
+    /* HISTORY_SIZE [samples] */
+    if((error = DESC_GetUInt32(llHdl->descHdl, 0,
+								&llHdl->histSize, "HISTORY_SIZE")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
+		return( Cleanup(llHdl,error) );
+	/* check range */
+	if( llHdl->histSize > HIST_SIZE_MAX )
+		return( Cleanup(llHdl,ERR_LL_DESC_PARAM) );
+
+	if( llHdl->histSize ){
+		if( (llHdl->hist = (u_int8*)OSS_MemGet( osHdl,
+					llHdl->histSize * CH_NUMBER, &llHdl->histMem )) == NULL )
+			return( Cleanup(llHdl,ERR_OSS_MEM_ALLOC) );
+	}
+
+    /* SNAPSHOT_MODE */
+    if((error = DESC_GetUInt32(llHdl->descHdl, 0,
+								&llHdl->snapMode, "SNAPSHOT_MODE")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
+		return( Cleanup(llHdl,error) );
+
+    /* BLOCK_READ */
+    if((error = DESC_GetUInt32(llHdl->descHdl, 0,
+								&llHdl->blkRead, "BLOCK_READ")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
+		return( Cleanup(llHdl,error) );
+
+    /* FWREV_CACHE */
+    if((error = DESC_GetUInt32(llHdl->descHdl, 1,
+								&fwRevCache, "FWREV_CACHE")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
+		return( Cleanup(llHdl,error) );
+
+    /* CTRL_NUMBER */
+    if((error = DESC_GetUInt32(llHdl->descHdl, 0,
+								&llHdl->ctrlNbr, "CTRL_NUMBER")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
+		return( Cleanup(llHdl,error) );
+	/* check range */
+	if( llHdl->ctrlNbr > CTRL_MAX )
+		return( Cleanup(llHdl,ERR_LL_DESC_PARAM) );
+
+	for( n=1; n<=llHdl->ctrlNbr; n++ ){
+	    /* CTRL_n/SMB_BUSNBR (required) */
+	    if((error = DESC_GetUInt32(llHdl->descHdl, 0,
+						&llHdl->ctrl[n].busNbr, "CTRL_%d/SMB_BUSNBR", n)))
+			return( Cleanup(llHdl,error) );
+
+	    /* CTRL_n/SMB_DEVADDR (required) */
+	    if((error = DESC_GetUInt32(llHdl->descHdl, 0,
+						&value, "CTRL_%d/SMB_DEVADDR", n)))
+			return( Cleanup(llHdl,error) );
+		llHdl->ctrl[n].smbAddr = (u_int16)value;
+	}
+
+    /*------------------------------+
+    |  init locking                 |
+    +------------------------------*/
+	/* LL_LOCK_NONE: the driver locks itself */
+    if((error = OSS_SpinLockCreate(llHdl->osHdl, &llHdl->busLock)) ||
+       (error = OSS_SpinLockCreate(llHdl->osHdl, &llHdl->svEvtLock)) ||
+       (error = OSS_SpinLockCreate(llHdl->osHdl, &llHdl->histLock)) ||
+       (error = OSS_SpinLockCreate(llHdl->osHdl, &llHdl->cfgLock)) ||
+       (error = OSS_SemCreate(llHdl->osHdl, OSS_SEM_BIN, 1, &llHdl->ctrlSem)) ||
+       (error = OSS_SemCreate(llHdl->osHdl, OSS_SEM_BIN, 0, &llHdl->svEvtSem)))
+		return( Cleanup(llHdl,error) );
+
+	/* SMBus handover semaphores (the alarm never waits) */
+	for( cls=0; cls<BUS_ALARM; cls++ ){
+		if((error = OSS_SemCreate(llHdl->osHdl, OSS_SEM_BIN, 0,
+								  &llHdl->busq[cls].grant)))
+			return( Cleanup(llHdl,error) );
+	}
+
     /*------------------------------+
     |  init alarm                   |
     +------------------------------*/
@@ -273,35 +709,101 @@ static int32 F14BC_Init(
 	if((error = OSS_GetSmbHdl( llHdl->osHdl, smbBusNbr, (void**)&llHdl->smbH) ))
 		return( Cleanup(llHdl,error) );
 
-    /*------------------------------+
-    |  init hardware                |
-    +------------------------------*/
-	/* get/save firmware rev. and check device access */
-	tmp = 0;
-	for( n=0; n<F14BCI_REV_BYTESIZE; n++ ){
+	/* multi-byte reads require plain I2C transfers */
+	if( llHdl->blkRead &&
+		(!(llHdl->smbH->Capability & SMB_FUNC_I2C) ||
+		 (llHdl->smbH->I2CXfer == NULL)) ){
+	    DBGWRT_2((DBH, " SMB controller without I2C support -> no block reads\n"));
+		llHdl->blkRead = 0;
+	}
+
+	/* this F14BC is the first supervised controller */
+	llHdl->ctrl[0].smbH    = llHdl->smbH;
+	llHdl->ctrl[0].busNbr  = smbBusNbr;
+	llHdl->ctrl[0].smbAddr = llHdl->smbAddr;
+	llHdl->ctrl[0].blkRead = (u_int8)llHdl->blkRead;
+
+	for( n=1; n<=llHdl->ctrlNbr; n++ ){
+		CTRL_DEV *dev = &llHdl->ctrl[n];
 
-		if( (error = llHdl->smbH->ReadByteData( llHdl->smbH, 0, llHdl->smbAddr,
-									(u_int8)F14BCI_GETREV(n), &llHdl->fwRev[n] ) ))
+		if((error = OSS_GetSmbHdl( llHdl->osHdl, dev->busNbr,
+								   (void**)&dev->smbH) ))
 			return( Cleanup(llHdl,error) );
 
-		/* firmware rev 2.0 or later? */
-		if( (llHdl->fwRev[n] >= '0') &&
-			(llHdl->fwRev[n] <= '9') )
-			tmp++;
+		dev->blkRead = llHdl->blkRead &&
+			(dev->smbH->Capability & SMB_FUNC_I2C) &&
+			(dev->smbH->I2CXfer != NULL);
 	}
 
+    /*------------------------------+
+    |  init hardware                |
+    +------------------------------*/
+	/* get firmware rev. (checks device access if not cached) */
+	if( (error = FwRevGet( llHdl, fwRevCache )) )
+		return( Cleanup(llHdl,error) );
+
 	DBGDMP_2((DBH, " PIC firmware revision (for rev. 2.0 and later)",
 		(void*)&llHdl->fwRev[0], F14BCI_REV_BYTESIZE, 1));
 
+	/* derive capabilities and bind handlers */
+	CapsInit( llHdl );
+
 	/* first firmware rev */
-	if( tmp != F14BCI_REV_BYTESIZE ){
+	if( !(llHdl->caps & F14BC_CAP_FW2) ){
 	    DBGWRT_2((DBH, " first PIC firmware revision -> restricted functionality\n"));
-		llHdl->fwRevFirst = TRUE;
 	}
 	else{
-		/* get WDOG state */
-		if( (error = llHdl->smbH->ReadByteData( llHdl->smbH, 0, llHdl->smbAddr,
-										F14BCI_WDSTATE, &llHdl->wdStatus ) ))
+		/* get WDOG state (checks device access if rev. was cached) */
+		if( (error = SmbXfer( llHdl, BUS_CALL, XFER_RD_BYTE_DATA,
+						F14BCI_WDSTATE, &llHdl->wdStatus, 1 )) )
+			return( Cleanup(llHdl,error) );
+
+		/* device answers: keep firmware rev. for the next open */
+		if( fwRevCache )
+			FwRevCacheSet( llHdl, TRUE );
+
+		/* get WDOG time (for trigger coalescing) */
+		if( llHdl->wdCoalesce ){
+			u_int16 word;
+
+			if( (error = SmbXfer( llHdl, BUS_CALL, XFER_RD_WORD_DATA,
+								F14BCI_WDTIME, &word, 2 )) )
+				return( Cleanup(llHdl,error) );
+			llHdl->wdTime = (u_int32)word * F14BCI_WDTIME_MSUNIT;
+		}
+	}
+
+	/* snapshot mode: take first snapshot and start polling */
+	if( llHdl->snapMode ){
+		if( !(llHdl->caps & F14BC_CAP_FW2) ){
+		    DBGWRT_2((DBH, " snapshot mode not supported -> disabled\n"));
+			llHdl->snapMode = 0;
+		}
+		else{
+			if( (error = SnapRefresh( llHdl, BUS_CALL )) )
+				return( Cleanup(llHdl,error) );
+			if( (error = AlarmUpdate( llHdl )) )
+				return( Cleanup(llHdl,error) );
+		}
+	}
+
+	/* additional controllers: first sweep (checks access) and start polling */
+	if( llHdl->ctrlNbr ){
+		if( !(llHdl->caps & F14BC_CAP_FW2) ){
+		    DBGWRT_2((DBH, " additional controllers not supported -> ignored\n"));
+			llHdl->ctrlNbr = 0;
+		}
+		else{
+			if( (error = CtrlSweep( llHdl, BUS_CALL, NULL )) )
+				return( Cleanup(llHdl,error) );
+			if( (error = AlarmUpdate( llHdl )) )
+				return( Cleanup(llHdl,error) );
+		}
+	}
+
+	/* voltage history: start polling */
+	if( llHdl->histSize && (llHdl->caps & F14BC_CAP_FW2) ){
+		if( (error = AlarmUpdate( llHdl )) )
 			return( Cleanup(llHdl,error) );
 	}
 
@@ -406,12 +908,18 @@ static int32 F14BC_SetStat(
 )
 {
 	int32	error = ERR_SUCCESS;
-	u_int8	byte;
+	u_int16	word;
+	u_int8	locked;
 	int32	value  	= (int32)value32_or_64;	/* 32bit value */
 
     DBGWRT_1((DBH, "LL - F14BC_SetStat: ch=%d code=0x%04x value=0x%x\n",
 			  ch,code,value));
 
+	/* serialize state changes, except the latency critical trigger paths */
+	locked = (code != WDOG_TRIG) && (code != F14BC_WDOG_ALIVE);
+	if( locked )
+		OSS_SemWait( llHdl->osHdl, llHdl->ctrlSem, OSS_SEM_WAITFOREVER );
+
 	switch(code) {
         /*--------------------------+
         |  debug level              |
@@ -430,51 +938,29 @@ static int32 F14BC_SetStat(
         |  start WDOG               |
         +--------------------------*/
         case WDOG_START:
-			if( (error = llHdl->smbH->WriteByte( llHdl->smbH, 0,
-						llHdl->smbAddr, F14BCI_WDON )) )
+			if( (error = llHdl->fwOps->wdogStart( llHdl )) )
 				break;
 
-			/* firmware rev. 2.0 and later */
-			if( !llHdl->fwRevFirst ){
-				/* verify the WDOG start */
-				if( (error = llHdl->smbH->ReadByteData( llHdl->smbH, 0,
-							llHdl->smbAddr, F14BCI_WDSTATE, &byte)) )
-					break;
-				if( !byte ){
-					error = ERR_LL_DEV_NOTRDY;
-					break;
-				}
-			}
-
 			llHdl->wdStatus = 1;
+			llHdl->wdTrigValid = FALSE;
+			llHdl->wdCallValid = FALSE;
+
+			/* auto-kick needs the alarm now */
+			if( llHdl->wdAuto )
+				error = AlarmUpdate( llHdl );
             break;
         /*--------------------------+
         |  stop WDOG                |
         +--------------------------*/
         case WDOG_STOP:
-			/* firmware rev. 1.x */
-			if( llHdl->fwRevFirst ){
-				if( (error = llHdl->smbH->WriteByte( llHdl->smbH, 0,
-							llHdl->smbAddr, F14BCI_WDOFF )) )
-					break;
-			}
-			/* firmware rev. 2.0 and later */
-			else{
-				if( (error = llHdl->smbH->WriteByteData( llHdl->smbH, 0,
-							llHdl->smbAddr, F14BCI_WDOFF, F14BCI_WDOFF_BYTE )) )
-					break;
-
-				/* verify the WDOG stop */
-				if( (error = llHdl->smbH->ReadByteData( llHdl->smbH, 0,
-							llHdl->smbAddr, F14BCI_WDSTATE, &byte)) )
-					break;
-				if( byte ){
-					error = ERR_LL_DEV_NOTRDY;
-					break;
-				}
-			}
+			if( (error = llHdl->fwOps->wdogStop( llHdl )) )
+				break;
 
 			llHdl->wdStatus = 0;
+
+			/* auto-kick doesn't need the alarm anymore */
+			if( llHdl->wdAuto )
+				error = AlarmUpdate( llHdl );
             break;
         /*--------------------------+
         |  trigger WDOG             |
@@ -485,8 +971,37 @@ static int32 F14BC_SetStat(
 				error = ERR_LL_DEV_NOTRDY;
 				break;
 			}
-			error = llHdl->smbH->WriteByte( llHdl->smbH, 0,
-						llHdl->smbAddr, F14BCI_WDTRIG );
+
+			/* coalescing */
+			if( llHdl->wdCoalesce && llHdl->wdTime ){
+				u_int32 now = OSS_TickGet( llHdl->osHdl ), sent, period;
+				u_int32 window = (llHdl->wdTime / 100) * llHdl->wdCoalesce;
+				u_int8	prev = llHdl->wdCallValid;
+
+				/* interval to the previous call: expected time of the next */
+				period = TickToMs( llHdl, now - llHdl->wdCallTick );
+				llHdl->wdCallTick  = now;
+				llHdl->wdCallValid = TRUE;
+
+				/*
+				 * skip if a trigger was sent within the window and the
+				 * next call still comes the window before the watchdog
+				 * expires (the window is also the tolerated caller jitter)
+				 */
+				sent = TickToMs( llHdl, now - llHdl->wdTrigTick );
+				if( llHdl->wdTrigValid && prev && (sent < window) &&
+					(sent + period < llHdl->wdTime - window) ){
+					llHdl->wdTrigSkip++;
+					break;
+				}
+			}
+
+			if( (error = SmbXfer( llHdl, BUS_WDOG, XFER_WR_BYTE,
+						F14BCI_WDTRIG, NULL, 0 )) )
+				break;
+
+			llHdl->wdTrigTick  = OSS_TickGet( llHdl->osHdl );
+			llHdl->wdTrigValid = TRUE;
             break;
         /*--------------------------+
         |  set WDOG time            |
@@ -499,9 +1014,120 @@ static int32 F14BC_SetStat(
 				error = ERR_LL_ILL_PARAM;
 				break;
 			}
-			error = llHdl->smbH->WriteWordData( llHdl->smbH, 0,
-									llHdl->smbAddr, F14BCI_WDTIME,
-									(u_int16)(value/F14BCI_WDTIME_MSUNIT) );
+			word = (u_int16)(value/F14BCI_WDTIME_MSUNIT);
+			if( (error = SmbXfer( llHdl, BUS_WDOG, XFER_WR_WORD_DATA,
+						F14BCI_WDTIME, &word, 2 )) )
+				break;
+
+			llHdl->wdTime = value;
+			llHdl->wdTrigValid = FALSE;
+
+			/* auto-kick: adapt alarm period */
+			if( llHdl->wdAuto )
+				error = AlarmUpdate( llHdl );
+            break;
+        /*--------------------------+
+        |  WDOG auto-kick mode      |
+        +--------------------------*/
+        case F14BC_WDOG_AUTO:
+			/* watchdog time required */
+			if( value && !llHdl->wdTime && (llHdl->caps & F14BC_CAP_FW2) ){
+				if( (error = SmbXfer( llHdl, BUS_WDOG, XFER_RD_WORD_DATA,
+							F14BCI_WDTIME, &word, 2 )) )
+					break;
+				llHdl->wdTime = (u_int32)word * F14BCI_WDTIME_MSUNIT;
+			}
+			if( value && !llHdl->wdTime ){
+				error = ERR_LL_DEV_NOTRDY;
+				break;
+			}
+
+			llHdl->wdAuto = value ? 1 : 0;
+			llHdl->wdKickElapsed = 0;
+			error = AlarmUpdate( llHdl );
+            break;
+        /*--------------------------+
+        |  clear SMBus queue stats  |
+        +--------------------------*/
+        case F14BC_BUSQ_CLR:
+		{
+			u_int32 cls;
+
+			OSS_SpinLockAcquire( llHdl->osHdl, llHdl->busLock );
+			for( cls=0; cls<BUS_CLASS_NBR; cls++ ){
+				llHdl->busq[cls].xfers    = 0;
+				llHdl->busq[cls].waits    = 0;
+				llHdl->busq[cls].depthMax = llHdl->busq[cls].waiting;
+				llHdl->busq[cls].waitMax  = 0;
+				llHdl->busq[cls].waitSum  = 0;
+			}
+			OSS_SpinLockRelease( llHdl->osHdl, llHdl->busLock );
+            break;
+		}
+        /*--------------------------+
+        |  clear SMBus statistics   |
+        +--------------------------*/
+        case F14BC_XFER_STAT_CLR:
+			/* counters are modified by the SMBus owner only */
+			if( (error = BusGet( llHdl, BUS_CALL )) )
+				break;
+
+			OSS_MemFill( llHdl->osHdl, sizeof(llHdl->xferCmd),
+				(char*)llHdl->xferCmd, 0x00 );
+			OSS_MemFill( llHdl->osHdl, sizeof(llHdl->xferErr),
+				(char*)llHdl->xferErr, 0x00 );
+			OSS_MemFill( llHdl->osHdl, sizeof(llHdl->xferLat),
+				(char*)llHdl->xferLat, 0x00 );
+			llHdl->xferTicks = 0;
+
+			BusRelease( llHdl );
+
+			OSS_SpinLockAcquire( llHdl->osHdl, llHdl->busLock );
+			llHdl->xferRetries = 0;
+			llHdl->brkTrips = 0;
+			OSS_SpinLockRelease( llHdl->osHdl, llHdl->busLock );
+            break;
+        /*--------------------------+
+        |  close circuit breaker    |
+        +--------------------------*/
+        case F14BC_BREAKER:
+			if( value != 0 ){
+				error = ERR_LL_ILL_PARAM;
+				break;
+			}
+
+			OSS_SpinLockAcquire( llHdl->osHdl, llHdl->busLock );
+			llHdl->brkOpen = FALSE;
+			llHdl->brkFaults = 0;
+			OSS_SpinLockRelease( llHdl->osHdl, llHdl->busLock );
+            break;
+        /*--------------------------+
+        |  register liveness token  |
+        +--------------------------*/
+        case F14BC_WDOG_TOKEN:
+		{
+			u_int32 id = (u_int32)value >> 24;
+
+			if( id >= WDTOKEN_NBR ){
+				error = ERR_LL_ILL_PARAM;
+				break;
+			}
+
+			llHdl->wdTokTick[id] = OSS_TickGet( llHdl->osHdl );
+			llHdl->wdTokTmo[id]  = (u_int32)value & 0x00ffffff;
+            break;
+		}
+        /*--------------------------+
+        |  refresh liveness token   |
+        +--------------------------*/
+        case F14BC_WDOG_ALIVE:
+			if( ((u_int32)value >= WDTOKEN_NBR) ||
+				!llHdl->wdTokTmo[value] ){
+				error = ERR_LL_ILL_PARAM;
+				break;
+			}
+
+			llHdl->wdTokTick[value] = OSS_TickGet( llHdl->osHdl );
             break;
 		/*--------------------------+
         |  software reset           |
@@ -512,15 +1138,10 @@ static int32 F14BC_SetStat(
 				error = ERR_LL_ILL_PARAM;
 				break;
 			}
-			/* firmware rev. 1.x */
-			if( llHdl->fwRevFirst )
-				error = llHdl->smbH->WriteByte( llHdl->smbH, 0,
-							llHdl->smbAddr, F14BCI_SWRESET );
-			else
-				/* firmware rev. 2.0 and later */
-				error = llHdl->smbH->WriteWordData( llHdl->smbH, 0,
-							llHdl->smbAddr, F14BCI_SWRESET,
-							F14BCI_SWRESET_WORD );
+			error = llHdl->fwOps->swReset( llHdl );
+
+			/* the PIC may come up with another firmware: read rev. again */
+			FwRevCacheSet( llHdl, FALSE );
             break;
         /*--------------------------+
         |  unknown                  |
@@ -529,110 +1150,259 @@ static int32 F14BC_SetStat(
 			error = ERR_LL_UNK_CODE;
     }
 
-	/*
-	 * additional functionality for
-	 *  firmware rev. 2.0 and later
-	 */
-	if( (llHdl->fwRevFirst == FALSE) &&
-		(error == ERR_LL_UNK_CODE) ){
-
-		error = ERR_SUCCESS;
-
-		switch(code)
-		{
-		   /*------------------------------------------+
-			|  install signal for voltage supervision  |
-			+-----------------------------------------*/
-			case F14BC_VOLT_SIGSET:
-			{
-				u_int32				realMsec;
-
-				/* illegal signal code ? */
-				if( value == 0 ){
-					DBGWRT_ERR((DBH, " *** F14BC_SetStat: illegal signal code=0x%x",
-						value));
-					error = ERR_LL_ILL_PARAM;
-					break;
-				}
-
-				/* already defined ? */
-				if( llHdl->sigHdl != NULL ){
-					DBGWRT_ERR((DBH, " *** F14BC_SetStat: signal already installed"));
-					error = ERR_OSS_SIG_SET;
-					break;
-				}
-
-				/* install signal+alarm */
-				if( (error = OSS_SigCreate(llHdl->osHdl, value, &llHdl->sigHdl)) )
-					break;
-
-				if( (error = OSS_AlarmSet(llHdl->osHdl, llHdl->alarmHdl,
-										  llHdl->pollPeriod, 1, &realMsec)) )
-					break;
-				break;
-			}
-			/*---------------------------------------+
-			|  deinstall signal for shutdown event   |
-			+---------------------------------------*/
-			case F14BC_VOLT_SIGCLR:
-				/* not defined ? */
-				if( llHdl->sigHdl == NULL ){
-					DBGWRT_ERR((DBH, " *** F14BC_SetStat: signal not installed"));
-					error = ERR_OSS_SIG_CLR;
-					break;
-				}
-
-  				/* remove signal+alarm */
-				if( (error = OSS_SigRemove(llHdl->osHdl, &llHdl->sigHdl)) )
-					break;
+	/* additional functionality of the firmware rev. (see CapsInit) */
+	if( error == ERR_LL_UNK_CODE )
+		error = llHdl->fwOps->setStat( llHdl, code, ch, value32_or_64 );
 
-				if( (error = OSS_AlarmClear(llHdl->osHdl, llHdl->alarmHdl)) )
-					break;
+	if( locked )
+		OSS_SemSignal( llHdl->osHdl, llHdl->ctrlSem );
 
-				break;
-			/*--------------------------+
-			|  clear all error counters |
-			+--------------------------*/
-			case F14BC_ERRCNT_CLR:
-				error = llHdl->smbH->WriteByte( llHdl->smbH, 0,
-							llHdl->smbAddr, F14BCI_ERRCNT_CLR );
-				break;
-			/*--------------------------+
-			|  unknown                  |
-			+--------------------------*/
-			default:
-				error = ERR_LL_UNK_CODE;
-		}
-	}
 	return(error);
 }
 
-/****************************** F14BC_GetStat *********************************/
-/** Get the driver status
+/******************************** SetStatRev1 *******************************/
+/** Set the driver status: no additional codes for firmware rev. 1.x
  *
- *  The driver supports \ref getstat_setstat_codes "these status codes"
- *  in addition to the standard codes (see mdis_api.h).
+ *  \param llHdl      \IN  Low-level handle
+ *  \param code       \IN  \ref getstat_setstat_codes "status code"
+ *  \param ch         \IN  Current channel
+ *  \param value32_or_64  \IN  Data or pointer to block data structure
+ *
+ *  \return           \c ERR_LL_UNK_CODE
+ */
+static int32 SetStatRev1(
+    LL_HANDLE *llHdl,
+    int32  code,
+    int32  ch,
+    INT32_OR_64 value32_or_64
+)
+{
+	return(ERR_LL_UNK_CODE);
+}
+
+/******************************** SetStatRev2 *******************************/
+/** Set the driver status: additional codes for firmware rev. 2.0 and later
+ *
+ *  Called by F14BC_SetStat() for the codes it doesn't handle itself,
+ *  with the same locking.
  *
  *  \param llHdl      \IN  Low-level handle
  *  \param code       \IN  \ref getstat_setstat_codes "status code"
  *  \param ch         \IN  Current channel
- *  \param *value32_or_64P  \IN  Pointer to block data structure (M_SG_BLOCK) for
- *                               block status codes
- *  \param *value32_or_64P  \OUT Data pointer or pointer to block data structure
- *                               (M_SG_BLOCK) for block status codes
+ *  \param value32_or_64  \IN  Data or pointer to block data structure
+ *                             (M_SG_BLOCK) for block status codes
  *
  *  \return           \c 0 On success or error code
  */
-static int32 F14BC_GetStat(
+static int32 SetStatRev2(
     LL_HANDLE *llHdl,
     int32  code,
     int32  ch,
-    INT32_OR_64 *value32_or_64P
+    INT32_OR_64 value32_or_64
+)
+{
+	int32	error = ERR_SUCCESS;
+	int32	value  	= (int32)value32_or_64;	/* 32bit value */
+
+	switch(code)
+	{
+	   /*------------------------------------------+
+		|  install signal for voltage supervision  |
+		+-----------------------------------------*/
+		case F14BC_VOLT_SIGSET:
+		{
+			/* illegal signal code ? */
+			if( value == 0 ){
+				DBGWRT_ERR((DBH, " *** F14BC_SetStat: illegal signal code=0x%x",
+					value));
+				error = ERR_LL_ILL_PARAM;
+				break;
+			}
+
+			/* already defined ? */
+			if( llHdl->sigHdl != NULL ){
+				DBGWRT_ERR((DBH, " *** F14BC_SetStat: signal already installed"));
+				error = ERR_OSS_SIG_SET;
+				break;
+			}
+
+			/* install signal+alarm */
+			if( (error = OSS_SigCreate(llHdl->osHdl, value, &llHdl->sigHdl)) )
+				break;
+
+			error = AlarmUpdate( llHdl );
+			break;
+		}
+		/*---------------------------------------+
+		|  deinstall signal for shutdown event   |
+		+---------------------------------------*/
+		case F14BC_VOLT_SIGCLR:
+			/* not defined ? */
+			if( llHdl->sigHdl == NULL ){
+				DBGWRT_ERR((DBH, " *** F14BC_SetStat: signal not installed"));
+				error = ERR_OSS_SIG_CLR;
+				break;
+			}
+
+  				/* remove signal+alarm */
+			if( (error = OSS_SigRemove(llHdl->osHdl, &llHdl->sigHdl)) )
+				break;
+
+			error = AlarmUpdate( llHdl );
+			break;
+		/*---------------------------------------+
+		|  set nominal/deviation voltage         |
+		+---------------------------------------*/
+		case F14BC_VOLT_NOM:
+		case F14BC_VOLT_DEV:
+		{
+			u_int8 nom[CH_NUMBER], dev[CH_NUMBER];
+
+			if( (error = CfgCheck( value )) ||
+				(error = CfgLoad( llHdl, BUS_CALL, nom, dev )) )
+				break;
+
+			if( code == F14BC_VOLT_NOM )
+				nom[ch] = (u_int8)(value / F14BCI_VOLT_MVUNIT);
+			else
+				dev[ch] = (u_int8)(value / F14BCI_VOLT_MVUNIT);
+
+			error = CfgWrite( llHdl, nom, dev );
+			break;
+		}
+		/*---------------------------------------+
+		|  set all nominal/deviation voltages    |
+		+---------------------------------------*/
+		case F14BC_BLK_VOLT_CFG:
+		{
+			M_SG_BLOCK	*blk = (M_SG_BLOCK*)value32_or_64;
+			F14BC_VOLT	*volt = (F14BC_VOLT*)blk->data;
+			u_int8		nom[CH_NUMBER], dev[CH_NUMBER], n;
+
+			if( blk->size < (int32)(CH_NUMBER * sizeof(F14BC_VOLT)) ){
+				error = ERR_LL_USERBUF;
+				break;
+			}
+
+			/* check the whole set before touching the PIC */
+			for( n=0; n<CH_NUMBER; n++ ){
+				if( (error = CfgCheck( volt[n].nom )) ||
+					(error = CfgCheck( volt[n].dev )) )
+					break;
+				nom[n] = (u_int8)(volt[n].nom / F14BCI_VOLT_MVUNIT);
+				dev[n] = (u_int8)(volt[n].dev / F14BCI_VOLT_MVUNIT);
+			}
+			if( error )
+				break;
+
+			error = CfgWrite( llHdl, nom, dev );
+			break;
+		}
+		/*---------------------------------------+
+		|  set voltage warning thresholds        |
+		+---------------------------------------*/
+		case F14BC_VOLT_WARN_LO:
+		case F14BC_VOLT_WARN_HI:
+		{
+			u_int8 n;
+
+			/* out of range? */
+			if( (value < 0) || (value > 0xff * F14BCI_VOLT_MVUNIT) ){
+				error = ERR_LL_ILL_PARAM;
+				break;
+			}
+
+			if( code == F14BC_VOLT_WARN_LO )
+				llHdl->warnLo[ch] = value;
+			else
+				llHdl->warnHi[ch] = value;
+
+			llHdl->warnOn = FALSE;
+			for( n=0; n<CH_NUMBER; n++ ){
+				if( llHdl->warnLo[n] || llHdl->warnHi[n] )
+					llHdl->warnOn = TRUE;
+			}
+
+			/* thresholds are checked by the supervision poll */
+			error = AlarmUpdate( llHdl );
+			break;
+		}
+		/*---------------------------------------+
+		|  start/stop supervision poll           |
+		+---------------------------------------*/
+		case F14BC_VOLT_POLL:
+			llHdl->svPoll = value ? 1 : 0;
+			error = AlarmUpdate( llHdl );
+			break;
+		/*--------------------------+
+		|  set event read timeout   |
+		+--------------------------*/
+		case F14BC_SVEVT_TOUT:
+			if( value < OSS_SEM_WAITFOREVER ){
+				error = ERR_LL_ILL_PARAM;
+				break;
+			}
+			llHdl->svEvtTout = (int32)value;
+			error = AlarmUpdate( llHdl );
+			break;
+		/*--------------------------+
+		|  clear voltage history    |
+		+--------------------------*/
+		case F14BC_VOLT_HIST_CLR:
+			OSS_SpinLockAcquire( llHdl->osHdl, llHdl->histLock );
+			llHdl->histStart = llHdl->histCnt;
+			OSS_SpinLockRelease( llHdl->osHdl, llHdl->histLock );
+			break;
+		/*--------------------------+
+		|  clear all error counters |
+		+--------------------------*/
+		case F14BC_ERRCNT_CLR:
+			if( (error = SmbXfer( llHdl, BUS_CALL, XFER_WR_BYTE,
+						F14BCI_ERRCNT_CLR, NULL, 0 )) )
+				break;
+
+			/* don't serve the old counters until the next refresh */
+			if( llHdl->snapMode ){
+				OSS_MemFill( llHdl->osHdl, ERRCNT_NUMBER,
+					(char*)llHdl->snap[0].errCnt, 0x00 );
+				OSS_MemFill( llHdl->osHdl, ERRCNT_NUMBER,
+					(char*)llHdl->snap[1].errCnt, 0x00 );
+			}
+			break;
+		/*--------------------------+
+		|  unknown                  |
+		+--------------------------*/
+		default:
+			error = ERR_LL_UNK_CODE;
+	}
+
+	return(error);
+}
+
+/****************************** F14BC_GetStat *********************************/
+/** Get the driver status
+ *
+ *  The driver supports \ref getstat_setstat_codes "these status codes"
+ *  in addition to the standard codes (see mdis_api.h).
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *  \param code       \IN  \ref getstat_setstat_codes "status code"
+ *  \param ch         \IN  Current channel
+ *  \param *value32_or_64P  \IN  Pointer to block data structure (M_SG_BLOCK) for
+ *                               block status codes
+ *  \param *value32_or_64P  \OUT Data pointer or pointer to block data structure
+ *                               (M_SG_BLOCK) for block status codes
+ *
+ *  \return           \c 0 On success or error code
+ */
+static int32 F14BC_GetStat(
+    LL_HANDLE *llHdl,
+    int32  code,
+    int32  ch,
+    INT32_OR_64 *value32_or_64P
 )
 {
 	int32	error = ERR_SUCCESS;
-	u_int16	word;
-	u_int8	byte, c = (u_int8)ch;
 
 	int32		*valueP	   = (int32*)value32_or_64P;		/* pointer to 32bit value  */
 	INT32_OR_64	*value64P  = value32_or_64P;		 		/* stores 32/64bit pointer */
@@ -679,247 +1449,627 @@ static int32 F14BC_GetStat(
         case M_MK_BLK_REV_ID:
            *value64P = (INT32_OR_64)&llHdl->idFuncTbl;
            break;
-       /*--------------------------+
-        |  unknown                  |
+        /*--------------------------+
+        |  coalesced WDOG triggers  |
         +--------------------------*/
-        default:
-			error = ERR_LL_UNK_CODE;
-    }
+        case F14BC_WDOG_TRIGSKIP:
+            *valueP = (int32)llHdl->wdTrigSkip;
+            break;
+        /*--------------------------+
+        |  WDOG auto-kick mode      |
+        +--------------------------*/
+        case F14BC_WDOG_AUTO:
+            *valueP = (int32)llHdl->wdAuto;
+            break;
+        /*--------------------------+
+        |  circuit breaker state    |
+        +--------------------------*/
+        case F14BC_BREAKER:
+            *valueP = (int32)llHdl->brkOpen;
+            break;
+        /*--------------------------+
+        |  capabilities             |
+        +--------------------------*/
+        case F14BC_CAPS:
+		{
+			u_int32 caps = llHdl->caps;
 
-	/*
-	 * additional functionality for
-	 *  firmware rev. 2.0 and later
-	 */
-	if( (llHdl->fwRevFirst == FALSE) &&
-		(error == ERR_LL_UNK_CODE) ){
+			/* supervised channels: nominal voltages (cached) */
+			if( caps & F14BC_CAP_FW2 ){
+				u_int8 nom[CH_NUMBER], n;
 
-		error = ERR_SUCCESS;
+				if( (error = RegReadBlk( llHdl, BUS_CALL, F14BCI_VOLT_NOM(0),
+										 CH_NUMBER, nom )) )
+					break;
 
-		switch(code)
+				for( n=0; n<CH_NUMBER; n++ ){
+					if( nom[n] )
+						caps |= F14BC_CAP_CH(n);
+				}
+			}
+            *valueP = (int32)caps;
+            break;
+		}
+        /*--------------------------+
+        |  SMBus queue statistics   |
+        +--------------------------*/
+        case F14BC_BLK_BUSQ_STAT:
 		{
-			/*--------------------------+
-			|  get WDOG time            |
-			+--------------------------*/
-			case WDOG_TIME:
-				error = llHdl->smbH->ReadWordData( llHdl->smbH, 0,
-										llHdl->smbAddr, F14BCI_WDTIME, &word);
-				*valueP = (u_int32)(word * F14BCI_WDTIME_MSUNIT);
-				break;
-			/*--------------------------+
-			|  get WDOG state           |
-			+--------------------------*/
-			case WDOG_STATUS:
-				error = llHdl->smbH->ReadByteData( llHdl->smbH, 0,
-										llHdl->smbAddr, F14BCI_WDSTATE, &byte);
-				*valueP = (u_int32)byte;
-				break;
-			/*--------------------------+
-			|  get input voltage        |
-			+--------------------------*/
-			case F14BC_VOLT_IN:
-				error = llHdl->smbH->ReadByteData( llHdl->smbH, 0,
-										llHdl->smbAddr, F14BCI_VOLT_IN(c), &byte);
-				*valueP = (u_int32)(byte * F14BCI_VOLT_MVUNIT);
-				break;
-			/*--------------------------+
-			|  get nominal voltage      |
-			+--------------------------*/
-			case F14BC_VOLT_NOM:
-				error = llHdl->smbH->ReadByteData( llHdl->smbH, 0,
-										llHdl->smbAddr, F14BCI_VOLT_NOM(c), &byte);
-				*valueP = (u_int32)(byte * F14BCI_VOLT_MVUNIT);
-				break;
-			/*--------------------------+
-			|  get deviation voltage    |
-			+--------------------------*/
-			case F14BC_VOLT_DEV:
-				error = llHdl->smbH->ReadByteData( llHdl->smbH, 0,
-										llHdl->smbAddr, F14BCI_VOLT_DEV(c), &byte);
-				*valueP = (u_int32)(byte * F14BCI_VOLT_MVUNIT);
-				break;
-			/*--------------------------+
-			|  get supervision state    |
-			+--------------------------*/
-			case F14BC_VOLT_SVSTATE:
-				*valueP = (int32)llHdl->voltSvState;
-				break;
-			/*--------------------------+
-			|  get error count - WDOG   |
-			+--------------------------*/
-			case F14BC_ERRCNT_WDOG:
-				error = llHdl->smbH->ReadByteData(
-											llHdl->smbH, 0, llHdl->smbAddr,
-											F14BCI_ERRCNT_NO_TRIG, &byte);
-				*valueP = (u_int32)byte;
-				break;
-			/*--------------------------+
-			|  get error count - BIOS_1 |
-			+--------------------------*/
-			case F14BC_ERRCNT_BIOS_1:
-				error = llHdl->smbH->ReadByteData(
-											llHdl->smbH, 0, llHdl->smbAddr,
-											F14BCI_ERRCNT_BIOS_1, &byte);
-				*valueP = (u_int32)byte;
-				break;
-			/*--------------------------+
-			|  get error count - BIOS_2 |
-			+--------------------------*/
-			case F14BC_ERRCNT_BIOS_2:
-				error = llHdl->smbH->ReadByteData(
-											llHdl->smbH, 0, llHdl->smbAddr,
-											F14BCI_ERRCNT_BIOS_2, &byte);
-				*valueP = (u_int32)byte;
-				break;
-			/*--------------------------+
-			|  get error count - SLP_S5 |
-			+--------------------------*/
-			case F14BC_ERRCNT_SLP_S5:
-				error = llHdl->smbH->ReadByteData(
-										llHdl->smbH, 0, llHdl->smbAddr,
-										F14BCI_ERRCNT_NO_SLP_S5, &byte);
-				*valueP = (u_int32)byte;
-				break;
-			/*--------------------------+
-			|  get error count - RST    |
-			+--------------------------*/
-			case F14BC_ERRCNT_RST:
-				error = llHdl->smbH->ReadByteData(
-										llHdl->smbH, 0, llHdl->smbAddr,
-										F14BCI_ERRCNT_RST_ACTIVE, &byte);
-				*valueP = (u_int32)byte;
-				break;
-			/*--------------------------+
-			|  get error count - TEMP   |
-			+--------------------------*/
-			case F14BC_ERRCNT_TEMP:
-				error = llHdl->smbH->ReadByteData(
-										llHdl->smbH, 0, llHdl->smbAddr,
-										F14BCI_ERRCNT_TEMP, &byte);
-				*valueP = (u_int32)byte;
+			M_SG_BLOCK		*blk = (M_SG_BLOCK*)value32_or_64P;
+			F14BC_BUSQ_STAT	*stat = (F14BC_BUSQ_STAT*)blk->data;
+			u_int32			cls;
+
+			/* check blk size */
+			if( blk->size < (int32)(BUS_CLASS_NBR * sizeof(F14BC_BUSQ_STAT)) ){
+				error = ERR_LL_USERBUF;
 				break;
-			/*----------------------------+
-			|  get error count - PROCHOT  |
-			+----------------------------*/
-			case F14BC_ERRCNT_PROCHOT:
-				error = llHdl->smbH->ReadByteData(
-										llHdl->smbH, 0, llHdl->smbAddr,
-										F14BCI_ERRCNT_PROCHOT, &byte);
-				*valueP = (u_int32)byte;
+			}
+
+			OSS_SpinLockAcquire( llHdl->osHdl, llHdl->busLock );
+			for( cls=0; cls<BUS_CLASS_NBR; cls++ ){
+				stat[cls].xfers    = llHdl->busq[cls].xfers;
+				stat[cls].waits    = llHdl->busq[cls].waits;
+				stat[cls].depth    = llHdl->busq[cls].waiting;
+				stat[cls].depthMax = llHdl->busq[cls].depthMax;
+				stat[cls].waitMax  = llHdl->busq[cls].waitMax;
+				stat[cls].waitSum  = llHdl->busq[cls].waitSum;
+			}
+			OSS_SpinLockRelease( llHdl->osHdl, llHdl->busLock );
+            break;
+		}
+        /*--------------------------+
+        |  SMBus statistics         |
+        +--------------------------*/
+        case F14BC_BLK_XFER_STAT:
+		{
+			M_SG_BLOCK		*blk = (M_SG_BLOCK*)value32_or_64P;
+			F14BC_XFER_STAT	*stat = (F14BC_XFER_STAT*)blk->data;
+
+			/* check blk size */
+			if( blk->size < (int32)sizeof(F14BC_XFER_STAT) ){
+				error = ERR_LL_USERBUF;
 				break;
-			/*--------------------------+
-			|  get firmware revision    |
-			+--------------------------*/
-			case F14BC_BLK_FWREV:
-			{
-				M_SG_BLOCK *blk = (M_SG_BLOCK*)value32_or_64P; 	/* stores block struct pointer */
-
-				/* check blk size */
-				if( blk->size < F14BCI_REV_BYTESIZE ){
-					error = ERR_LL_USERBUF;
-					break;
-				}
+			}
 
-				OSS_MemCopy( llHdl->osHdl, F14BCI_REV_BYTESIZE,
-					(char*)llHdl->fwRev, (char*)blk->data);
+			/* consistent copy: counters are modified by the SMBus owner only */
+			if( (error = BusGet( llHdl, BUS_CALL )) )
 				break;
+
+			OSS_MemCopy( llHdl->osHdl, sizeof(stat->cmd),
+				(char*)llHdl->xferCmd, (char*)stat->cmd );
+			OSS_MemCopy( llHdl->osHdl, sizeof(stat->err),
+				(char*)llHdl->xferErr, (char*)stat->err );
+			OSS_MemCopy( llHdl->osHdl, sizeof(stat->lat),
+				(char*)llHdl->xferLat, (char*)stat->lat );
+			stat->time     = TickToMs( llHdl, llHdl->xferTicks );
+			stat->tickRate = OSS_TickRateGet( llHdl->osHdl );
+			stat->retries = llHdl->xferRetries;
+			stat->trips   = llHdl->brkTrips;
+
+			BusRelease( llHdl );
+            break;
+		}
+        /*--------------------------+
+        |  batch getstat            |
+        +--------------------------*/
+        case F14BC_BLK_MULTI:
+		{
+			M_SG_BLOCK	*blk = (M_SG_BLOCK*)value32_or_64P;
+			F14BC_MULTI	*req = (F14BC_MULTI*)blk->data;
+			int32		val, i, nbr = blk->size / (int32)sizeof(F14BC_MULTI);
+
+			for( i=0; i<nbr; i++ ){
+				val = 0;
+
+				/* block codes need their own buffer, no recursion */
+				if( CODE_IS_BLK(req[i].code) )
+					req[i].err = ERR_LL_ILL_PARAM;
+				else if( (req[i].ch < 0) || (req[i].ch >= CH_NUMBER) )
+					req[i].err = ERR_LL_ILL_CHAN;
+				else
+					req[i].err = F14BC_GetStat( llHdl, req[i].code, req[i].ch,
+												(INT32_OR_64*)&val );
+
+				req[i].value = val;
 			}
-			/*--------------------------+
-			|  unknown                  |
-			+--------------------------*/
-			default:
-				error = ERR_LL_UNK_CODE;
+            break;
 		}
-	}
+       /*--------------------------+
+        |  unknown                  |
+        +--------------------------*/
+        default:
+			error = ERR_LL_UNK_CODE;
+    }
+
+	/* additional functionality of the firmware rev. (see CapsInit) */
+	if( error == ERR_LL_UNK_CODE )
+		error = llHdl->fwOps->getStat( llHdl, code, ch, value32_or_64P );
+
 	return(error);
 }
 
-/******************************* F14BC_BlockRead ******************************/
-/** Read a data block from the device
- *
- *  The function is not supported and always returns an ERR_LL_ILL_FUNC error.
+/******************************** GetStatRev1 *******************************/
+/** Get the driver status: no additional codes for firmware rev. 1.x
  *
- *  \param llHdl       \IN  Low-level handle
- *  \param ch          \IN  Current channel
- *  \param buf         \IN  Data buffer
- *  \param size        \IN  Data buffer size
- *  \param nbrRdBytesP \OUT Number of read bytes
+ *  \param llHdl      \IN  Low-level handle
+ *  \param code       \IN  \ref getstat_setstat_codes "status code"
+ *  \param ch         \IN  Current channel
+ *  \param value32_or_64P  \IN  Data pointer or pointer to block data structure
  *
- *  \return            \c 0 On success or error code
+ *  \return           \c ERR_LL_UNK_CODE
  */
-static int32 F14BC_BlockRead(
-     LL_HANDLE *llHdl,
-     int32     ch,
-     void      *buf,
-     int32     size,
-     int32     *nbrRdBytesP
+static int32 GetStatRev1(
+    LL_HANDLE *llHdl,
+    int32  code,
+    int32  ch,
+    INT32_OR_64 *value32_or_64P
 )
 {
-    DBGWRT_1((DBH, "LL - F14BC_BlockRead: ch=%d, size=%d\n",ch,size));
-
-	/* return number of read bytes */
-	*nbrRdBytesP = 0;
-
-	return(ERR_LL_ILL_FUNC);
+	return(ERR_LL_UNK_CODE);
 }
 
-/****************************** F14BC_BlockWrite ******************************/
-/** Write a data block from the device
+/******************************** GetStatRev2 *******************************/
+/** Get the driver status: additional codes for firmware rev. 2.0 and later
  *
- *  The function is not supported and always returns an ERR_LL_ILL_FUNC error.
+ *  Called by F14BC_GetStat() for the codes it doesn't handle itself.
  *
- *  \param llHdl  	   \IN  Low-level handle
- *  \param ch          \IN  Current channel
- *  \param buf         \IN  Data buffer
- *  \param size        \IN  Data buffer size
- *  \param nbrWrBytesP \OUT Number of written bytes
+ *  \param llHdl      \IN  Low-level handle
+ *  \param code       \IN  \ref getstat_setstat_codes "status code"
+ *  \param ch         \IN  Current channel
+ *  \param *value32_or_64P  \IN  Pointer to block data structure (M_SG_BLOCK) for
+ *                               block status codes
+ *  \param *value32_or_64P  \OUT Data pointer or pointer to block data structure
+ *                               (M_SG_BLOCK) for block status codes
  *
- *  \return            \c ERR_LL_ILL_FUNC
+ *  \return           \c 0 On success or error code
  */
-static int32 F14BC_BlockWrite(
-     LL_HANDLE *llHdl,
-     int32     ch,
-     void      *buf,
-     int32     size,
-     int32     *nbrWrBytesP
+static int32 GetStatRev2(
+    LL_HANDLE *llHdl,
+    int32  code,
+    int32  ch,
+    INT32_OR_64 *value32_or_64P
 )
 {
-    DBGWRT_1((DBH, "LL - F14BC_BlockWrite: ch=%d, size=%d\n",ch,size));
-
-	/* return number of written bytes */
-	*nbrWrBytesP = 0;
-
-	return(ERR_LL_ILL_FUNC);
-}
-
+	int32	error = ERR_SUCCESS;
+	u_int16	word;
+	u_int8	byte, c = (u_int8)ch;
 
-/****************************** F14BC_Irq ************************************/
-/** Interrupt service routine - unused
- *
- *  If the driver can detect the interrupt's cause it returns
- *  LL_IRQ_DEVICE or LL_IRQ_DEV_NOT, otherwise LL_IRQ_UNKNOWN.
- *
- *  \param llHdl  	   \IN  Low-level handle
- *  \return LL_IRQ_DEVICE	IRQ caused by device
- *          LL_IRQ_DEV_NOT  IRQ not caused by device
- *          LL_IRQ_UNKNOWN  Unknown
- */
-static int32 F14BC_Irq(
-   LL_HANDLE *llHdl
-)
-{
-	return(LL_IRQ_DEV_NOT);
-}
+	int32		*valueP	   = (int32*)value32_or_64P;		/* pointer to 32bit value  */
 
-/****************************** F14BC_Info ***********************************/
-/** Get information about hardware and driver requirements
- *
- *  The following info codes are supported:
- *
- * \code
- *  Code                      Description
- *  ------------------------  -----------------------------
- *  LL_INFO_HW_CHARACTER      Hardware characteristics
- *  LL_INFO_ADDRSPACE_COUNT   Number of required address spaces
+	switch(code)
+	{
+		/*--------------------------+
+		|  get WDOG time            |
+		+--------------------------*/
+		case WDOG_TIME:
+			error = SmbXfer( llHdl, BUS_CALL, XFER_RD_WORD_DATA,
+						F14BCI_WDTIME, &word, 2 );
+			*valueP = (u_int32)(word * F14BCI_WDTIME_MSUNIT);
+			break;
+		/*--------------------------+
+		|  get WDOG state           |
+		+--------------------------*/
+		case WDOG_STATUS:
+			if( (error = SmbXfer( llHdl, BUS_CALL, XFER_RD_BYTE_DATA,
+						F14BCI_WDSTATE, &byte, 1 )) )
+				break;
+			llHdl->wdStatus = byte ? 1 : 0;
+			*valueP = (u_int32)byte;
+			break;
+		/*--------------------------+
+		|  get input voltage        |
+		+--------------------------*/
+		case F14BC_VOLT_IN:
+			error = RegRead( llHdl, F14BCI_VOLT_IN(c), &byte );
+			*valueP = (u_int32)(byte * F14BCI_VOLT_MVUNIT);
+			break;
+		/*--------------------------+
+		|  get nominal voltage      |
+		+--------------------------*/
+		case F14BC_VOLT_NOM:
+			error = RegRead( llHdl, F14BCI_VOLT_NOM(c), &byte );
+			*valueP = (u_int32)(byte * F14BCI_VOLT_MVUNIT);
+			break;
+		/*--------------------------+
+		|  get deviation voltage    |
+		+--------------------------*/
+		case F14BC_VOLT_DEV:
+			error = RegRead( llHdl, F14BCI_VOLT_DEV(c), &byte );
+			*valueP = (u_int32)(byte * F14BCI_VOLT_MVUNIT);
+			break;
+		/*--------------------------+
+		|  get supervision state    |
+		+--------------------------*/
+		case F14BC_VOLT_SVSTATE:
+			*valueP = (int32)llHdl->voltSvState;
+			break;
+		/*--------------------------+
+		|  get current sv. state    |
+		+--------------------------*/
+		case F14BC_VOLT_SVCUR:
+			*valueP = (int32)llHdl->svLast;
+			break;
+		/*--------------------------+
+		|  get supervision poll     |
+		+--------------------------*/
+		case F14BC_VOLT_POLL:
+			*valueP = (int32)llHdl->svPoll;
+			break;
+		/*--------------------------+
+		|  get event read timeout   |
+		+--------------------------*/
+		case F14BC_SVEVT_TOUT:
+			*valueP = (int32)llHdl->svEvtTout;
+			break;
+		/*--------------------------+
+		|  get warning thresholds   |
+		+--------------------------*/
+		case F14BC_VOLT_WARN_LO:
+			*valueP = (int32)llHdl->warnLo[c];
+			break;
+		case F14BC_VOLT_WARN_HI:
+			*valueP = (int32)llHdl->warnHi[c];
+			break;
+		/*--------------------------+
+		|  get warning state        |
+		+--------------------------*/
+		case F14BC_VOLT_WARNSTATE:
+			*valueP = (int32)llHdl->warnState;
+			break;
+		/*--------------------------+
+		|  get poll period          |
+		+--------------------------*/
+		case F14BC_POLL_PERIOD:
+			*valueP = (int32)llHdl->pollPeriod;
+			break;
+		/*--------------------------+
+		|  get lost events          |
+		+--------------------------*/
+		case F14BC_SVEVT_LOST:
+			*valueP = (int32)llHdl->svEvtLost;
+			break;
+		/*--------------------------+
+		|  get failed polls         |
+		+--------------------------*/
+		case F14BC_POLL_FAIL:
+			*valueP = (int32)llHdl->pollFail;
+			break;
+		/*--------------------------+
+		|  get snapshot age         |
+		+--------------------------*/
+		case F14BC_SNAP_AGE:
+			if( !llHdl->snapMode ){
+				error = ERR_LL_DEV_NOTRDY;
+				break;
+			}
+			*valueP = (int32)TickToMs( llHdl, OSS_TickGet(llHdl->osHdl) -
+							llHdl->snap[llHdl->snapIdx].tick );
+			break;
+		/*--------------------------+
+		|  get error count - WDOG   |
+		+--------------------------*/
+		case F14BC_ERRCNT_WDOG:
+			error = RegRead( llHdl, F14BCI_ERRCNT_NO_TRIG, &byte );
+			*valueP = (u_int32)byte;
+			break;
+		/*--------------------------+
+		|  get error count - BIOS_1 |
+		+--------------------------*/
+		case F14BC_ERRCNT_BIOS_1:
+			error = RegRead( llHdl, F14BCI_ERRCNT_BIOS_1, &byte );
+			*valueP = (u_int32)byte;
+			break;
+		/*--------------------------+
+		|  get error count - BIOS_2 |
+		+--------------------------*/
+		case F14BC_ERRCNT_BIOS_2:
+			error = RegRead( llHdl, F14BCI_ERRCNT_BIOS_2, &byte );
+			*valueP = (u_int32)byte;
+			break;
+		/*--------------------------+
+		|  get error count - SLP_S5 |
+		+--------------------------*/
+		case F14BC_ERRCNT_SLP_S5:
+			error = RegRead( llHdl, F14BCI_ERRCNT_NO_SLP_S5, &byte );
+			*valueP = (u_int32)byte;
+			break;
+		/*--------------------------+
+		|  get error count - RST    |
+		+--------------------------*/
+		case F14BC_ERRCNT_RST:
+			error = RegRead( llHdl, F14BCI_ERRCNT_RST_ACTIVE, &byte );
+			*valueP = (u_int32)byte;
+			break;
+		/*--------------------------+
+		|  get error count - TEMP   |
+		+--------------------------*/
+		case F14BC_ERRCNT_TEMP:
+			error = RegRead( llHdl, F14BCI_ERRCNT_TEMP, &byte );
+			*valueP = (u_int32)byte;
+			break;
+		/*----------------------------+
+		|  get error count - PROCHOT  |
+		+----------------------------*/
+		case F14BC_ERRCNT_PROCHOT:
+			error = RegRead( llHdl, F14BCI_ERRCNT_PROCHOT, &byte );
+			*valueP = (u_int32)byte;
+			break;
+		/*--------------------------+
+		|  get firmware revision    |
+		+--------------------------*/
+		case F14BC_BLK_FWREV:
+		{
+			M_SG_BLOCK *blk = (M_SG_BLOCK*)value32_or_64P; 	/* stores block struct pointer */
+
+			/* check blk size */
+			if( blk->size < F14BCI_REV_BYTESIZE ){
+				error = ERR_LL_USERBUF;
+				break;
+			}
+
+			OSS_MemCopy( llHdl->osHdl, F14BCI_REV_BYTESIZE,
+				(char*)llHdl->fwRev, (char*)blk->data);
+			break;
+		}
+		/*--------------------------+
+		|  get all voltages         |
+		+--------------------------*/
+		case F14BC_BLK_VOLT_ALL:
+		{
+			M_SG_BLOCK	*blk = (M_SG_BLOCK*)value32_or_64P;
+			F14BC_VOLT	*volt = (F14BC_VOLT*)blk->data;
+			u_int8		in[CH_NUMBER], nom[CH_NUMBER], dev[CH_NUMBER], n;
+
+			/* check blk size */
+			if( blk->size < (int32)(CH_NUMBER * sizeof(F14BC_VOLT)) ){
+				error = ERR_LL_USERBUF;
+				break;
+			}
+
+			if( (error = RegReadBlk( llHdl, BUS_CALL, F14BCI_VOLT_IN(0),
+									 CH_NUMBER, in )) ||
+				(error = RegReadBlk( llHdl, BUS_CALL, F14BCI_VOLT_NOM(0),
+									 CH_NUMBER, nom )) ||
+				(error = RegReadBlk( llHdl, BUS_CALL, F14BCI_VOLT_DEV(0),
+									 CH_NUMBER, dev )) )
+				break;
+
+			for( n=0; n<CH_NUMBER; n++ ){
+				volt[n].in  = (int32)(in[n]  * F14BCI_VOLT_MVUNIT);
+				volt[n].nom = (int32)(nom[n] * F14BCI_VOLT_MVUNIT);
+				volt[n].dev = (int32)(dev[n] * F14BCI_VOLT_MVUNIT);
+			}
+			break;
+		}
+		/*--------------------------+
+		|  get all error counters   |
+		+--------------------------*/
+		case F14BC_BLK_ERRCNT_ALL:
+		{
+			M_SG_BLOCK *blk = (M_SG_BLOCK*)value32_or_64P;
+
+			/* check blk size */
+			if( blk->size < ERRCNT_NUMBER ){
+				error = ERR_LL_USERBUF;
+				break;
+			}
+
+			error = RegReadBlk( llHdl, BUS_CALL, F14BCI_ERRCNT_NO_TRIG,
+								ERRCNT_NUMBER, (u_int8*)blk->data );
+			break;
+		}
+		/*--------------------------+
+		|  get supervision events   |
+		+--------------------------*/
+		case F14BC_BLK_SVEVENTS:
+		{
+			M_SG_BLOCK *blk = (M_SG_BLOCK*)value32_or_64P;
+
+			blk->size = SvEvtGet( llHdl, (F14BC_SVEVENT*)blk->data,
+						blk->size / sizeof(F14BC_SVEVENT) ) *
+						sizeof(F14BC_SVEVENT);
+			break;
+		}
+		/*--------------------------+
+		|  get voltage history      |
+		+--------------------------*/
+		case F14BC_BLK_VOLT_HIST:
+		{
+			M_SG_BLOCK *blk = (M_SG_BLOCK*)value32_or_64P;
+
+			/* history not enabled? */
+			if( !llHdl->histSize ){
+				error = ERR_LL_DEV_NOTRDY;
+				break;
+			}
+
+			/* check blk size */
+			if( blk->size < (int32)(CH_NUMBER * sizeof(F14BC_VOLT_STAT)) ){
+				error = ERR_LL_USERBUF;
+				break;
+			}
+
+			HistStat( llHdl, (F14BC_VOLT_STAT*)blk->data );
+			break;
+		}
+		/*--------------------------+
+		|  get controller states    |
+		+--------------------------*/
+		case F14BC_BLK_CTRL_SNAP:
+		{
+			M_SG_BLOCK		*blk = (M_SG_BLOCK*)value32_or_64P;
+			F14BC_CTRL_SNAP	*snap = (F14BC_CTRL_SNAP*)blk->data;
+			u_int32			idx = llHdl->ctrlIdx, i;
+			CTRL_DEV		*dev;
+			CTRL_SWEEP		*sw;
+			u_int8			n;
+
+			/* no additional controllers? */
+			if( !llHdl->ctrlNbr ){
+				error = ERR_LL_DEV_NOTRDY;
+				break;
+			}
+
+			/* check blk size */
+			if( blk->size < (int32)((1 + llHdl->ctrlNbr) *
+									sizeof(F14BC_CTRL_SNAP)) ){
+				error = ERR_LL_USERBUF;
+				break;
+			}
+
+			for( i=0; i<=llHdl->ctrlNbr; i++ ){
+				dev = &llHdl->ctrl[i];
+				sw  = &dev->sweep[idx];
+
+				snap[i].busNbr  = dev->busNbr;
+				snap[i].smbAddr = dev->smbAddr;
+				snap[i].error   = sw->error;
+				snap[i].time    = TickToMs( llHdl,
+									sw->tick - llHdl->initTick );
+				snap[i].svState = sw->svState;
+				for( n=0; n<CH_NUMBER; n++ )
+					snap[i].in[n] = (int32)(sw->voltIn[n] *
+											F14BCI_VOLT_MVUNIT);
+				for( n=0; n<ERRCNT_NUMBER; n++ )
+					snap[i].errCnt[n] = sw->errCnt[n];
+			}
+
+			blk->size = (1 + llHdl->ctrlNbr) * sizeof(F14BC_CTRL_SNAP);
+			break;
+		}
+		/*--------------------------+
+		|  unknown                  |
+		+--------------------------*/
+		default:
+			error = ERR_LL_UNK_CODE;
+	}
+
+	return(error);
+}
+
+/******************************* F14BC_BlockRead ******************************/
+/** Read a data block from the device
+ *
+ *  The function reads the pending voltage supervision events
+ *  (F14BC_SVEVENT structures, see #F14BC_BLK_SVEVENTS) of the driver's
+ *  event ring into the buffer. The channel is ignored.
+ *
+ *  If no event is pending, the function waits up to #F14BC_SVEVT_TOUT
+ *  for the next event and returns all events pending then. On timeout,
+ *  it returns without error and 0 bytes. The wait holds no driver lock.
+ *
+ *  \param llHdl       \IN  Low-level handle
+ *  \param ch          \IN  Current channel
+ *  \param buf         \IN  Data buffer
+ *  \param size        \IN  Data buffer size
+ *  \param nbrRdBytesP \OUT Number of read bytes
+ *
+ *  \return            \c 0 On success or error code
+ */
+static int32 F14BC_BlockRead(
+     LL_HANDLE *llHdl,
+     int32     ch,
+     void      *buf,
+     int32     size,
+     int32     *nbrRdBytesP
+)
+{
+	int32	nbr, n, total = llHdl->svEvtTout, tout = total;
+	u_int32	start, ms;
+
+    DBGWRT_1((DBH, "LL - F14BC_BlockRead: ch=%d, size=%d\n",ch,size));
+
+	/* return number of read bytes */
+	*nbrRdBytesP = 0;
+
+	/* firmware rev. 1.x */
+	if( !(llHdl->caps & F14BC_CAP_FW2) )
+		return(ERR_LL_ILL_FUNC);
+
+	nbr = size / sizeof(F14BC_SVEVENT);
+
+	/* wait for events (a signal may be left from events already taken
+	   with F14BC_BLK_SVEVENTS, so check the ring again and wait only for
+	   the rest of the timeout) */
+	start = OSS_TickGet( llHdl->osHdl );
+
+	while( ((n = SvEvtGet( llHdl, (F14BC_SVEVENT*)buf, nbr )) == 0) &&
+		   nbr && tout ){
+		if( OSS_SemWait( llHdl->osHdl, llHdl->svEvtSem, tout ) ){
+			DBGWRT_2((DBH, " no event within %dms\n", total));
+			break;
+		}
+
+		/* remaining time (0: check the ring a last time) */
+		if( total != OSS_SEM_WAITFOREVER ){
+			ms = TickToMs( llHdl, OSS_TickGet(llHdl->osHdl) - start );
+			tout = (ms < (u_int32)total) ? total - (int32)ms : 0;
+		}
+	}
+
+	*nbrRdBytesP = n * sizeof(F14BC_SVEVENT);
+
+	return(ERR_SUCCESS);
+}
+
+/****************************** F14BC_BlockWrite ******************************/
+/** Write a data block from the device
+ *
+ *  The function is not supported and always returns an ERR_LL_ILL_FUNC error.
+ *
+ *  \param llHdl  	   \IN  Low-level handle
+ *  \param ch          \IN  Current channel
+ *  \param buf         \IN  Data buffer
+ *  \param size        \IN  Data buffer size
+ *  \param nbrWrBytesP \OUT Number of written bytes
+ *
+ *  \return            \c ERR_LL_ILL_FUNC
+ */
+static int32 F14BC_BlockWrite(
+     LL_HANDLE *llHdl,
+     int32     ch,
+     void      *buf,
+     int32     size,
+     int32     *nbrWrBytesP
+)
+{
+    DBGWRT_1((DBH, "LL - F14BC_BlockWrite: ch=%d, size=%d\n",ch,size));
+
+	/* return number of written bytes */
+	*nbrWrBytesP = 0;
+
+	return(ERR_LL_ILL_FUNC);
+}
+
+
+/****************************** F14BC_Irq ************************************/
+/** Interrupt service routine - unused
+ *
+ *  If the driver can detect the interrupt's cause it returns
+ *  LL_IRQ_DEVICE or LL_IRQ_DEV_NOT, otherwise LL_IRQ_UNKNOWN.
+ *
+ *  \param llHdl  	   \IN  Low-level handle
+ *  \return LL_IRQ_DEVICE	IRQ caused by device
+ *          LL_IRQ_DEV_NOT  IRQ not caused by device
+ *          LL_IRQ_UNKNOWN  Unknown
+ */
+static int32 F14BC_Irq(
+   LL_HANDLE *llHdl
+)
+{
+	return(LL_IRQ_DEV_NOT);
+}
+
+/****************************** F14BC_Info ***********************************/
+/** Get information about hardware and driver requirements
+ *
+ *  The following info codes are supported:
+ *
+ * \code
+ *  Code                      Description
+ *  ------------------------  -----------------------------
+ *  LL_INFO_HW_CHARACTER      Hardware characteristics
+ *  LL_INFO_ADDRSPACE_COUNT   Number of required address spaces
  *  LL_INFO_ADDRSPACE         Address space information
  *  LL_INFO_IRQ               Interrupt required
  *  LL_INFO_LOCKMODE          Process lock mode required
@@ -1021,7 +2171,7 @@ static int32 F14BC_Info(
 		{
 			u_int32 *lockModeP = va_arg(argptr, u_int32*);
 
-			*lockModeP = LL_LOCK_CALL;
+			*lockModeP = LL_LOCK_NONE;
 			break;
 	    }
 		/*-------------------------------+
@@ -1060,6 +2210,12 @@ static int32 Cleanup(
    int32        retCode
 )
 {
+	u_int32 n;
+
+	/* device failed: don't trust a cached firmware rev. at the next open */
+	if( retCode && llHdl->ctrl[0].smbH )
+		FwRevCacheSet( llHdl, FALSE );
+
     /*------------------------------+
     |  close handles                |
     +------------------------------*/
@@ -1075,6 +2231,28 @@ static int32 Cleanup(
 	if (llHdl->sigHdl)
 		OSS_SigRemove(llHdl->osHdl, &llHdl->sigHdl);
 
+	/* clean up semaphores */
+	for (n=0; n<BUS_CLASS_NBR; n++) {
+		if (llHdl->busq[n].grant)
+			OSS_SemRemove(llHdl->osHdl, &llHdl->busq[n].grant);
+	}
+	if (llHdl->busLock)
+		OSS_SpinLockRemove(llHdl->osHdl, &llHdl->busLock);
+	if (llHdl->svEvtLock)
+		OSS_SpinLockRemove(llHdl->osHdl, &llHdl->svEvtLock);
+	if (llHdl->histLock)
+		OSS_SpinLockRemove(llHdl->osHdl, &llHdl->histLock);
+	if (llHdl->cfgLock)
+		OSS_SpinLockRemove(llHdl->osHdl, &llHdl->cfgLock);
+	if (llHdl->ctrlSem)
+		OSS_SemRemove(llHdl->osHdl, &llHdl->ctrlSem);
+	if (llHdl->svEvtSem)
+		OSS_SemRemove(llHdl->osHdl, &llHdl->svEvtSem);
+
+	/* free voltage history */
+	if (llHdl->hist)
+		OSS_MemFree(llHdl->osHdl, (int8*)llHdl->hist, llHdl->histMem);
+
 	/* clean up debug */
 	DBGEXIT((&DBH));
 
@@ -1103,18 +2281,1671 @@ static void AlarmHandler(void *arg)
 {
 	LL_HANDLE	*llHdl = (LL_HANDLE*)arg;
 	int32		error;
-	u_int8		state;
+	u_int8		state, warn, sig, in[CH_NUMBER], *inP = NULL;
 
 	DBGWRT_3((DBH,">>> LL - F14BC AlarmHandler:\n"));
 
-	error = llHdl->smbH->ReadByteData( llHdl->smbH, 0, llHdl->smbAddr,
-							F14BCI_VOLT_SVSTATE, &state);
+	/* watchdog auto-kick */
+	if( llHdl->wdAuto )
+		WdogAutoKick( llHdl );
+
+	/* supervision poll not required or not due? */
+	if( !SV_POLL_REQUIRED(llHdl) )
+		return;
+	if( llHdl->pollElapsed < llHdl->pollPeriod )
+		llHdl->pollElapsed += llHdl->alarmMs;
+	if( llHdl->pollElapsed < llHdl->pollPeriod )
+		return;
+
+	/* snapshot mode: refresh all registers (includes the state) */
+	if( llHdl->snapMode ){
+		error = SnapRefresh( llHdl, BUS_ALARM );
+		state = llHdl->snap[llHdl->snapIdx].svState;
+	}
+	else{
+		error = SmbXfer( llHdl, BUS_ALARM, XFER_RD_BYTE_DATA,
+						 F14BCI_VOLT_SVSTATE, &state, 1 );
+	}
+
+	/* SMBus busy or error: retry with next alarm */
+	if( error ){
+		if( error != ERR_OSS_BUSY ){
+			DBGWRT_ERR((DBH, " *** F14BC AlarmHandler: poll failed, error=0x%x\n",
+				error));
+			llHdl->pollFail++;
+		}
+		return;
+	}
+	llHdl->pollElapsed = 0;
+
+	/* input voltages required? */
+	if( llHdl->ctrlNbr || llHdl->warnOn || llHdl->histSize ||
+		((llHdl->pollMin != llHdl->pollMax) && !state) ){
+		if( !(error = RegReadBlk( llHdl, BUS_ALARM, F14BCI_VOLT_IN(0),
+								  CH_NUMBER, in )) )
+			inP = in;
+	}
+
+	/* sweep additional controllers, this F14BC from the registers read above */
+	if( llHdl->ctrlNbr ){
+		CTRL_SWEEP own;
+
+		if( !error )
+			error = RegReadBlk( llHdl, BUS_ALARM, F14BCI_ERRCNT_NO_TRIG,
+								ERRCNT_NUMBER, own.errCnt );
+		if( !error ){
+			OSS_MemCopy( llHdl->osHdl, CH_NUMBER, (char*)in,
+						 (char*)own.voltIn );
+			own.svState = state;
+			own.tick    = OSS_TickGet( llHdl->osHdl );
+		}
+		own.error = error;
+
+		CtrlSweep( llHdl, BUS_ALARM, &own );
+	}
+
+	/* adaptive poll period */
+	if( llHdl->pollMin != llHdl->pollMax )
+		PollAdapt( llHdl, state, inP );
+
+	/* debounce/hysteresis, record state changes */
+	state = SvFilter( llHdl, state );
+	if( state != llHdl->svLast ){
+		SvEvtPut( llHdl, F14BC_SVEVT_SUPERV, state );
+		llHdl->svLast = state;
+		/* edge mode: signal state changes */
+		sig = llHdl->sigEdge ? TRUE : FALSE;
+	}
+	else
+		sig = FALSE;
+
+	/* level mode: signal each out of range poll */
+	if( !llHdl->sigEdge && state )
+		sig = TRUE;
 
-	if( !error && state ){
+	if( sig )
 		llHdl->voltSvState = state;
+
+	/* add input voltages to history */
+	if( inP && llHdl->histSize ){
+		OSS_SpinLockAcquire( llHdl->osHdl, llHdl->histLock );
+		OSS_MemCopy( llHdl->osHdl, CH_NUMBER, (char*)inP,
+			(char*)&llHdl->hist[(llHdl->histCnt % llHdl->histSize) * CH_NUMBER] );
+		llHdl->histCnt++;
+		OSS_SpinLockRelease( llHdl->osHdl, llHdl->histLock );
+	}
+
+	/* software thresholds: record/signal warning state changes */
+	if( inP && llHdl->warnOn ){
+		warn = WarnCheck( llHdl, inP );
+		if( warn != llHdl->warnState ){
+			SvEvtPut( llHdl, F14BC_SVEVT_WARN, warn );
+			llHdl->warnState = warn;
+			sig = TRUE;
+		}
+	}
+
+	if( sig && llHdl->sigHdl ){
 		DBGWRT_2((DBH, " voltSvState=0x%x --> send signal\n",
 			llHdl->voltSvState));
 		OSS_SigSend( llHdl->osHdl, llHdl->sigHdl );
 	}
 }
 
+/******************************** PollAdapt *********************************/
+/** Adapt the poll period
+ *
+ *  The poll period is set to POLL_PERIOD_MIN if a voltage is out of range
+ *  or its deviation from the nominal voltage exceeds POLL_NEAR_PCT of the
+ *  allowed deviation. Otherwise, the poll period is doubled up to
+ *  POLL_PERIOD_MAX.
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *  \param state      \IN  Polled supervision state
+ *  \param in         \IN  Input voltages or NULL if not available
+ */
+static void PollAdapt(
+	LL_HANDLE	*llHdl,
+	u_int8		state,
+	u_int8		*in
+)
+{
+	u_int8	nom[CH_NUMBER], dev[CH_NUMBER], n;
+	u_int32	diff, fast = state ? TRUE : FALSE;
+
+	if( !fast && in &&
+		!RegReadBlk( llHdl, BUS_ALARM, F14BCI_VOLT_NOM(0), CH_NUMBER, nom ) &&
+		!RegReadBlk( llHdl, BUS_ALARM, F14BCI_VOLT_DEV(0), CH_NUMBER, dev ) ){
+
+		for( n=0; n<CH_NUMBER; n++ ){
+			/* not supervised? */
+			if( !nom[n] || !dev[n] )
+				continue;
+
+			diff = (in[n] > nom[n]) ? in[n] - nom[n] : nom[n] - in[n];
+			if( diff * 100 >= (u_int32)dev[n] * POLL_NEAR_PCT ){
+				fast = TRUE;
+				break;
+			}
+		}
+	}
+
+	if( fast )
+		llHdl->pollPeriod = llHdl->pollMin;
+	else if( llHdl->pollPeriod < llHdl->pollMax ){
+		llHdl->pollPeriod *= 2;
+		if( llHdl->pollPeriod > llHdl->pollMax )
+			llHdl->pollPeriod = llHdl->pollMax - (llHdl->pollMax % llHdl->pollMin);
+	}
+
+	DBGWRT_3((DBH, " pollPeriod=%dms\n", llHdl->pollPeriod));
+}
+
+/******************************** WarnCheck *********************************/
+/** Compare the input voltages with the software warning thresholds
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *  \param in         \IN  Input voltages
+ *
+ *  \return           warning state bitmask (bit set = below low or
+ *                    above high threshold)
+ */
+static u_int8 WarnCheck(
+	LL_HANDLE	*llHdl,
+	u_int8		*in
+)
+{
+	u_int8	warn = 0, n;
+	u_int32	mv;
+
+	for( n=0; n<CH_NUMBER; n++ ){
+		mv = in[n] * F14BCI_VOLT_MVUNIT;
+
+		if( (llHdl->warnLo[n] && (mv < llHdl->warnLo[n])) ||
+			(llHdl->warnHi[n] && (mv > llHdl->warnHi[n])) )
+			warn |= (u_int8)(1 << n);
+	}
+
+	return(warn);
+}
+
+/********************************* HistStat *********************************/
+/** Get min/max/mean of the input voltages in the history window
+ *
+ *  The window contains the last HISTORY_SIZE samples, but only samples
+ *  taken after the last #F14BC_VOLT_HIST_CLR.
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *  \param stat       \OUT Statistics of all channels
+ */
+static void HistStat(
+	LL_HANDLE		*llHdl,
+	F14BC_VOLT_STAT	*stat
+)
+{
+	u_int32	cnt, nbr;
+	u_int32	sum[CH_NUMBER], i;
+	u_int8	*smp, n;
+
+	for( n=0; n<CH_NUMBER; n++ ){
+		stat[n].min = 0xff;
+		stat[n].max = 0;
+		sum[n] = 0;
+	}
+
+	/* the alarm must not overwrite samples meanwhile */
+	OSS_SpinLockAcquire( llHdl->osHdl, llHdl->histLock );
+
+	cnt = llHdl->histCnt;
+	nbr = cnt - llHdl->histStart;
+	if( nbr > llHdl->histSize )
+		nbr = llHdl->histSize;
+
+	for( i=0; i<nbr; i++ ){
+		smp = &llHdl->hist[((cnt - 1 - i) % llHdl->histSize) * CH_NUMBER];
+
+		for( n=0; n<CH_NUMBER; n++ ){
+			if( smp[n] < stat[n].min )
+				stat[n].min = smp[n];
+			if( smp[n] > stat[n].max )
+				stat[n].max = smp[n];
+			sum[n] += smp[n];
+		}
+	}
+
+	OSS_SpinLockRelease( llHdl->osHdl, llHdl->histLock );
+
+	for( n=0; n<CH_NUMBER; n++ ){
+		if( !nbr )
+			stat[n].min = 0;
+
+		stat[n].min *= F14BCI_VOLT_MVUNIT;
+		stat[n].max *= F14BCI_VOLT_MVUNIT;
+		stat[n].avg = nbr ? (int32)((sum[n] * F14BCI_VOLT_MVUNIT) / nbr) : 0;
+		stat[n].samples = nbr;
+	}
+}
+
+/******************************* WdogAutoKick *******************************/
+/** Trigger the watchdog from the alarm
+ *
+ *  The watchdog is triggered each WDOG_KICK_PERIOD as long as at least one
+ *  liveness token is registered and all registered tokens were refreshed
+ *  within their deadline. Otherwise, the watchdog is no longer triggered
+ *  and resets the board.
+ *
+ *  \param llHdl      \IN  Low-level handle
+ */
+static void WdogAutoKick(
+	LL_HANDLE *llHdl
+)
+{
+	u_int32	now, n, tokens = 0;
+	int32	error;
+
+	if( !llHdl->wdStatus )
+		return;
+
+	llHdl->wdKickElapsed += llHdl->alarmMs;
+	if( llHdl->wdKickElapsed < WDOG_KICK_PERIOD(llHdl) )
+		return;
+
+	/* all registered clients alive? */
+	now = OSS_TickGet( llHdl->osHdl );
+	for( n=0; n<WDTOKEN_NBR; n++ ){
+		if( !llHdl->wdTokTmo[n] )
+			continue;
+
+		if( TickToMs( llHdl, now - llHdl->wdTokTick[n] ) > llHdl->wdTokTmo[n] ){
+			DBGWRT_ERR((DBH, " *** F14BC AlarmHandler: token %d expired\n", n));
+			return;
+		}
+		tokens++;
+	}
+	if( !tokens )
+		return;
+
+	/* SMBus busy: the trigger is sent by BusRelease() before the SMBus is
+	   handed over to any waiting caller (highest priority) */
+	while( (error = SmbXfer( llHdl, BUS_ALARM, XFER_WR_BYTE,
+							 F14BCI_WDTRIG, NULL, 0 )) == ERR_OSS_BUSY ){
+		OSS_SpinLockAcquire( llHdl->osHdl, llHdl->busLock );
+		if( llHdl->busBusy ){
+			llHdl->wdKickPend = TRUE;
+			OSS_SpinLockRelease( llHdl->osHdl, llHdl->busLock );
+			return;
+		}
+		/* released meanwhile: try again */
+		OSS_SpinLockRelease( llHdl->osHdl, llHdl->busLock );
+	}
+
+	/* error: retry with next alarm */
+	if( error )
+		return;
+
+	llHdl->wdKickElapsed = 0;
+	llHdl->wdTrigTick  = now;
+	llHdl->wdTrigValid = TRUE;
+}
+
+/****************************** WdogKickPending *****************************/
+/** Send a pending auto trigger of the watchdog
+ *
+ *  Called by BusRelease() while the SMBus is still owned, after the alarm
+ *  found the SMBus busy (see WdogAutoKick). The releasing caller is never
+ *  the alarm, so transient errors are retried with backoff like in
+ *  SmbXfer(). If the trigger still fails, the alarm retries it with its
+ *  next call.
+ *
+ *  \param llHdl      \IN  Low-level handle
+ */
+static void WdogKickPending(
+	LL_HANDLE *llHdl
+)
+{
+	u_int32	tick, try;
+	int32	error;
+
+	for( try=0; ; try++ ){
+		tick = OSS_TickGet( llHdl->osHdl );
+		error = llHdl->smbH->WriteByte( llHdl->smbH, 0, llHdl->smbAddr,
+										F14BCI_WDTRIG );
+		SMB2_ERRMAP( error );
+		XferStat( llHdl, F14BCI_WDTRIG, error,
+				  OSS_TickGet(llHdl->osHdl) - tick );
+
+		if( !XFER_TRANSIENT(error) || (try >= llHdl->xferRetry) )
+			break;
+
+		OSS_Delay( llHdl->osHdl, XferBackoff( llHdl, try ) );
+	}
+
+	BreakerUpdate( llHdl, error );
+
+	if( error ){
+		DBGWRT_ERR((DBH, " *** F14BC WdogKickPending: error=0x%x\n", error));
+		return;
+	}
+
+	llHdl->wdKickElapsed = 0;
+	llHdl->wdTrigTick  = tick;
+	llHdl->wdTrigValid = TRUE;
+}
+
+/********************************* SvFilter *********************************/
+/** Debounce the polled supervision state
+ *
+ *  A voltage is considered out of range after SV_DEBOUNCE consecutive
+ *  out of range polls and in range again after SV_HYSTERESIS consecutive
+ *  in range polls.
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *  \param raw        \IN  Polled state bitmask
+ *
+ *  \return           filtered state bitmask
+ */
+static u_int8 SvFilter(
+	LL_HANDLE	*llHdl,
+	u_int8		raw
+)
+{
+	u_int8	state = llHdl->svLast;
+	u_int8	n, bit;
+
+	for( n=0; n<CH_NUMBER; n++ ){
+		bit = (u_int8)(1 << n);
+
+		/* new out of range? */
+		if( (raw & bit) && !(state & bit) ){
+			llHdl->svClrCnt[n] = 0;
+			if( ++llHdl->svSetCnt[n] >= llHdl->svDebounce ){
+				llHdl->svSetCnt[n] = 0;
+				state |= bit;
+			}
+		}
+		/* back in range? */
+		else if( !(raw & bit) && (state & bit) ){
+			llHdl->svSetCnt[n] = 0;
+			if( ++llHdl->svClrCnt[n] >= llHdl->svHyst ){
+				llHdl->svClrCnt[n] = 0;
+				state &= ~bit;
+			}
+		}
+		/* unchanged */
+		else{
+			llHdl->svSetCnt[n] = 0;
+			llHdl->svClrCnt[n] = 0;
+		}
+	}
+
+	return(state);
+}
+
+/******************************* AlarmUpdate ********************************/
+/** Start, stop or reprogram the alarm depending on its users
+ *
+ *  The supervision poll is required as long as a signal is installed,
+ *  the supervision poll is enabled or the snapshot mode is enabled. It
+ *  needs an alarm period of POLL_PERIOD_MIN. The watchdog auto-kick is
+ *  required while the watchdog is running and needs an alarm period of
+ *  WDOG_KICK_PERIOD.
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *
+ *  \return           \c 0 On success or error code
+ */
+static int32 AlarmUpdate(
+	LL_HANDLE *llHdl
+)
+{
+	int32	error = ERR_SUCCESS;
+	u_int32	realMsec, ms = 0;
+
+	if( SV_POLL_REQUIRED(llHdl) )
+		ms = llHdl->pollMin;
+
+	if( llHdl->wdAuto && llHdl->wdStatus ){
+		if( !ms || (WDOG_KICK_PERIOD(llHdl) < ms) )
+			ms = WDOG_KICK_PERIOD(llHdl);
+	}
+
+	/* stop alarm if not required or period changed */
+	if( llHdl->alarmOn && (ms != llHdl->alarmMs) ){
+		if( (error = OSS_AlarmClear(llHdl->osHdl, llHdl->alarmHdl)) )
+			return(error);
+		llHdl->alarmOn = FALSE;
+	}
+
+	/* start alarm */
+	if( ms && !llHdl->alarmOn ){
+		llHdl->pollElapsed = 0;
+		if( (error = OSS_AlarmSet(llHdl->osHdl, llHdl->alarmHdl,
+								  ms, 1, &realMsec)) )
+			return(error);
+		llHdl->alarmMs = ms;
+		llHdl->alarmOn = TRUE;
+	}
+
+	return(error);
+}
+
+/********************************* CapsInit *********************************/
+/** Derive the capabilities from the firmware revision
+ *
+ *  The firmware dependent handlers (watchdog, reset and the additional
+ *  getstat/setstat codes of rev. 2.0) are bound here, so the entry points
+ *  don't have to check the firmware revision for each call. The
+ *  F14BC_CAP_CH(c) bits are derived from the voltage configuration on
+ *  each request (#F14BC_CAPS).
+ *
+ *  \param llHdl      \IN  Low-level handle
+ */
+static void CapsInit(
+	LL_HANDLE *llHdl
+)
+{
+	u_int8 n;
+
+	llHdl->caps = 0;
+
+	/* firmware rev 2.0 or later: revision is an ascii number */
+	for( n=0; n<F14BCI_REV_BYTESIZE; n++ ){
+		if( (llHdl->fwRev[n] < '0') ||
+			(llHdl->fwRev[n] > '9') )
+			break;
+	}
+	if( n == F14BCI_REV_BYTESIZE )
+		llHdl->caps |= F14BC_CAP_FW2;
+
+	if( llHdl->blkRead )
+		llHdl->caps |= F14BC_CAP_BLKRD;
+
+	llHdl->fwOps = (llHdl->caps & F14BC_CAP_FW2) ?
+					&G_fwOpsRev2 : &G_fwOpsRev1;
+}
+
+/******************************* WdogStartRev1 ******************************/
+/** Start the watchdog (firmware rev. 1.x)
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *
+ *  \return           \c 0 On success or error code
+ */
+static int32 WdogStartRev1(
+	LL_HANDLE *llHdl
+)
+{
+	return( SmbXfer( llHdl, BUS_WDOG, XFER_WR_BYTE, F14BCI_WDON, NULL, 0 ) );
+}
+
+/******************************* WdogStartRev2 ******************************/
+/** Start and verify the watchdog (firmware rev. 2.0 and later)
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *
+ *  \return           \c 0 On success or error code
+ */
+static int32 WdogStartRev2(
+	LL_HANDLE *llHdl
+)
+{
+	int32	error;
+	u_int8	byte;
+
+	if( (error = SmbXfer( llHdl, BUS_WDOG, XFER_WR_BYTE,
+						  F14BCI_WDON, NULL, 0 )) ||
+		(error = SmbXfer( llHdl, BUS_WDOG, XFER_RD_BYTE_DATA,
+						  F14BCI_WDSTATE, &byte, 1 )) )
+		return(error);
+
+	return( byte ? ERR_SUCCESS : ERR_LL_DEV_NOTRDY );
+}
+
+/******************************* WdogStopRev1 *******************************/
+/** Stop the watchdog (firmware rev. 1.x)
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *
+ *  \return           \c 0 On success or error code
+ */
+static int32 WdogStopRev1(
+	LL_HANDLE *llHdl
+)
+{
+	return( SmbXfer( llHdl, BUS_WDOG, XFER_WR_BYTE, F14BCI_WDOFF, NULL, 0 ) );
+}
+
+/******************************* WdogStopRev2 *******************************/
+/** Stop and verify the watchdog (firmware rev. 2.0 and later)
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *
+ *  \return           \c 0 On success or error code
+ */
+static int32 WdogStopRev2(
+	LL_HANDLE *llHdl
+)
+{
+	int32	error;
+	u_int8	byte = F14BCI_WDOFF_BYTE;
+
+	if( (error = SmbXfer( llHdl, BUS_WDOG, XFER_WR_BYTE_DATA,
+						  F14BCI_WDOFF, &byte, 1 )) ||
+		(error = SmbXfer( llHdl, BUS_WDOG, XFER_RD_BYTE_DATA,
+						  F14BCI_WDSTATE, &byte, 1 )) )
+		return(error);
+
+	return( byte ? ERR_LL_DEV_NOTRDY : ERR_SUCCESS );
+}
+
+/******************************* SwResetRev1 ********************************/
+/** Perform a software reset (firmware rev. 1.x)
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *
+ *  \return           \c 0 On success or error code
+ */
+static int32 SwResetRev1(
+	LL_HANDLE *llHdl
+)
+{
+	return( SmbXfer( llHdl, BUS_CALL, XFER_WR_BYTE, F14BCI_SWRESET, NULL, 0 ) );
+}
+
+/******************************* SwResetRev2 ********************************/
+/** Perform a software reset (firmware rev. 2.0 and later)
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *
+ *  \return           \c 0 On success or error code
+ */
+static int32 SwResetRev2(
+	LL_HANDLE *llHdl
+)
+{
+	u_int16 word = F14BCI_SWRESET_WORD;
+
+	return( SmbXfer( llHdl, BUS_CALL, XFER_WR_WORD_DATA,
+					 F14BCI_SWRESET, &word, 2 ) );
+}
+
+/********************************* FwRevGet *********************************/
+/** Get the PIC firmware revision
+ *
+ *  The revision is kept in the handle for #F14BC_BLK_FWREV. If a
+ *  previous open of the same F14BC (SMB bus and address) cached it, it is
+ *  taken from the cache without SMBus access. Otherwise it is read from
+ *  the PIC, with one I2C transfer if block reads are enabled.
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *  \param useCache   \IN  0: always read from the PIC (FWREV_CACHE=0)
+ *
+ *  \return           \c 0 On success or error code
+ */
+static int32 FwRevGet(
+	LL_HANDLE	*llHdl,
+	u_int32		useCache
+)
+{
+	FWREV_CACHE	*entry;
+	u_int32		i;
+
+	for( i=0; useCache && i<FWREV_CACHE_NBR; i++ ){
+		entry = &G_fwRevCache[i];
+
+		if( entry->valid &&
+			(entry->busNbr == llHdl->ctrl[0].busNbr) &&
+			(entry->smbAddr == llHdl->smbAddr) ){
+			OSS_MemCopy( llHdl->osHdl, F14BCI_REV_BYTESIZE,
+				(char*)entry->fwRev, (char*)llHdl->fwRev );
+			return(ERR_SUCCESS);
+		}
+	}
+
+	return( SmbReadBlk( llHdl, BUS_CALL, (u_int8)F14BCI_GETREV(0),
+						F14BCI_REV_BYTESIZE, llHdl->fwRev ) );
+}
+
+/****************************** FwRevCacheSet *******************************/
+/** Cache or drop the firmware revision of this F14BC
+ *
+ *  F14BC_Init() caches the revision only after the PIC answered a rev.
+ *  2.0 register read, so a cached revision never hides a missing device.
+ *  It is dropped when the device failed at init and after
+ *  #F14BC_SWRESET.
+ *
+ *  F14BC_Init() calls are serialized by MDIS. A concurrent drop (reset
+ *  of another path) only clears the valid flag, so the cache needs no
+ *  lock.
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *  \param valid      \IN  TRUE: cache llHdl->fwRev, FALSE: drop entry
+ */
+static void FwRevCacheSet(
+	LL_HANDLE	*llHdl,
+	u_int32		valid
+)
+{
+	FWREV_CACHE	*entry, *unused = NULL;
+	u_int32		i;
+
+	for( i=0; i<FWREV_CACHE_NBR; i++ ){
+		entry = &G_fwRevCache[i];
+
+		if( !entry->valid ){
+			if( !unused )
+				unused = entry;
+			continue;
+		}
+
+		if( (entry->busNbr == llHdl->ctrl[0].busNbr) &&
+			(entry->smbAddr == llHdl->smbAddr) ){
+			if( valid )
+				OSS_MemCopy( llHdl->osHdl, F14BCI_REV_BYTESIZE,
+					(char*)llHdl->fwRev, (char*)entry->fwRev );
+			else
+				entry->valid = FALSE;
+			return;
+		}
+	}
+
+	/* cache full: don't cache */
+	if( valid && unused ){
+		unused->busNbr  = llHdl->ctrl[0].busNbr;
+		unused->smbAddr = llHdl->smbAddr;
+		OSS_MemCopy( llHdl->osHdl, F14BCI_REV_BYTESIZE,
+			(char*)llHdl->fwRev, (char*)unused->fwRev );
+		unused->valid   = TRUE;
+	}
+}
+
+/******************************* SnapRefresh ********************************/
+/** Read all PIC registers into the snapshot
+ *
+ *  The registers are read into the unused half of the double buffer,
+ *  which becomes valid only if all reads succeeded. So readers always
+ *  see a complete snapshot without any locking.
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *  \param cls        \IN  SMBus access class (BUS_xxx)
+ *
+ *  \return           \c 0 On success or error code
+ */
+static int32 SnapRefresh(
+	LL_HANDLE	*llHdl,
+	u_int32		cls
+)
+{
+	u_int32		idx = llHdl->snapIdx ^ 1;
+	SNAPSHOT	*snap = &llHdl->snap[idx];
+	int32		error;
+
+	/* nominal/deviation voltages are cached (see CfgLoad()) */
+	if( (error = SmbReadBlk( llHdl, cls, F14BCI_VOLT_IN(0),
+							 CH_NUMBER, snap->voltIn )) ||
+		(error = SmbReadBlk( llHdl, cls, F14BCI_ERRCNT_NO_TRIG,
+							 ERRCNT_NUMBER, snap->errCnt )) )
+		return(error);
+
+	if( (error = SmbXfer( llHdl, cls, XFER_RD_BYTE_DATA,
+							F14BCI_VOLT_SVSTATE, &snap->svState, 1 )) )
+		return(error);
+
+	snap->tick = OSS_TickGet( llHdl->osHdl );
+	llHdl->snapIdx = idx;
+
+	return(ERR_SUCCESS);
+}
+
+/********************************* SnapReg **********************************/
+/** Get the snapshot location of a PIC register
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *  \param cmd        \IN  SMB command (F14BCI_xxx)
+ *
+ *  \return           pointer into the valid snapshot or NULL if the
+ *                    register is not part of the snapshot
+ */
+static u_int8 *SnapReg(
+	LL_HANDLE	*llHdl,
+	u_int8		cmd
+)
+{
+	SNAPSHOT *snap = &llHdl->snap[llHdl->snapIdx];
+
+	if( (cmd >= F14BCI_VOLT_IN(0)) && (cmd < F14BCI_VOLT_IN(CH_NUMBER)) )
+		return( &snap->voltIn[cmd - F14BCI_VOLT_IN(0)] );
+
+	if( (cmd >= F14BCI_ERRCNT_NO_TRIG) &&
+		(cmd < F14BCI_ERRCNT_NO_TRIG + ERRCNT_NUMBER) )
+		return( &snap->errCnt[cmd - F14BCI_ERRCNT_NO_TRIG] );
+
+	return(NULL);
+}
+
+/********************************** CfgReg **********************************/
+/** Get the location of a voltage configuration register in a copy of
+ *  the configuration
+ *
+ *  \param nom        \IN  nominal voltages
+ *  \param dev        \IN  deviation voltages
+ *  \param cmd        \IN  SMB command (F14BCI_xxx)
+ *
+ *  \return           pointer into nom/dev or NULL if the register is not
+ *                    a nominal/deviation voltage
+ */
+static u_int8 *CfgReg(
+	u_int8		*nom,
+	u_int8		*dev,
+	u_int8		cmd
+)
+{
+	if( (cmd >= F14BCI_VOLT_NOM(0)) && (cmd < F14BCI_VOLT_NOM(CH_NUMBER)) )
+		return( &nom[cmd - F14BCI_VOLT_NOM(0)] );
+
+	if( (cmd >= F14BCI_VOLT_DEV(0)) && (cmd < F14BCI_VOLT_DEV(CH_NUMBER)) )
+		return( &dev[cmd - F14BCI_VOLT_DEV(0)] );
+
+	return(NULL);
+}
+
+/********************************* CfgLoad **********************************/
+/** Get the voltage configuration
+ *
+ *  The nominal and deviation voltages are configuration values of the
+ *  PIC, so they are read only once into the configuration cache. The
+ *  cache is guarded by cfgLock, callers always get a copy. Values read
+ *  while CfgWrite() runs are returned but not cached (cfgGen).
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *  \param cls        \IN  SMBus access class (BUS_xxx)
+ *  \param nom        \OUT nominal voltages [25mV units]
+ *  \param dev        \OUT deviation voltages [25mV units]
+ *
+ *  \return           \c 0 On success or error code
+ */
+static int32 CfgLoad(
+	LL_HANDLE	*llHdl,
+	u_int32		cls,
+	u_int8		*nom,
+	u_int8		*dev
+)
+{
+	u_int32	gen;
+	int32	error;
+
+	OSS_SpinLockAcquire( llHdl->osHdl, llHdl->cfgLock );
+	if( llHdl->cfgValid ){
+		OSS_MemCopy( llHdl->osHdl, CH_NUMBER, (char*)llHdl->cfgNom,
+					 (char*)nom );
+		OSS_MemCopy( llHdl->osHdl, CH_NUMBER, (char*)llHdl->cfgDev,
+					 (char*)dev );
+		OSS_SpinLockRelease( llHdl->osHdl, llHdl->cfgLock );
+		return(ERR_SUCCESS);
+	}
+	gen = llHdl->cfgGen;
+	OSS_SpinLockRelease( llHdl->osHdl, llHdl->cfgLock );
+
+	if( (error = SmbReadBlk( llHdl, cls, F14BCI_VOLT_NOM(0),
+							 CH_NUMBER, nom )) ||
+		(error = SmbReadBlk( llHdl, cls, F14BCI_VOLT_DEV(0),
+							 CH_NUMBER, dev )) )
+		return(error);
+
+	/* cache only if no CfgWrite() was running meanwhile */
+	OSS_SpinLockAcquire( llHdl->osHdl, llHdl->cfgLock );
+	if( !llHdl->cfgValid && !(gen & 1) && (gen == llHdl->cfgGen) ){
+		OSS_MemCopy( llHdl->osHdl, CH_NUMBER, (char*)nom,
+					 (char*)llHdl->cfgNom );
+		OSS_MemCopy( llHdl->osHdl, CH_NUMBER, (char*)dev,
+					 (char*)llHdl->cfgDev );
+		llHdl->cfgValid = TRUE;
+	}
+	OSS_SpinLockRelease( llHdl->osHdl, llHdl->cfgLock );
+
+	return(ERR_SUCCESS);
+}
+
+/********************************* CfgCheck *********************************/
+/** Check a nominal/deviation voltage setstat value
+ *
+ *  \param mv         \IN  voltage [mV]
+ *
+ *  \return           \c 0 On success or ERR_LL_ILL_PARAM
+ */
+static int32 CfgCheck(
+	int32	mv
+)
+{
+	if( (mv < 0) || (mv > 0xff * F14BCI_VOLT_MVUNIT) ||
+		(mv % F14BCI_VOLT_MVUNIT) )
+		return(ERR_LL_ILL_PARAM);
+
+	return(ERR_SUCCESS);
+}
+
+/********************************* CfgWrite *********************************/
+/** Write the nominal/deviation voltages of all channels to the PIC
+ *
+ *  Only the registers that differ from the current configuration
+ *  (CfgLoad) are written. Afterwards both register ranges are read back
+ *  and compared. On success the cache holds the new values. While
+ *  writing and if any step fails, the cache is invalid.
+ *
+ *  Callers are serialized by ctrlSem.
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *  \param nom        \IN  nominal voltages [25mV units]
+ *  \param dev        \IN  deviation voltages [25mV units]
+ *
+ *  \return           \c 0 On success or error code
+ */
+static int32 CfgWrite(
+	LL_HANDLE	*llHdl,
+	u_int8		*nom,
+	u_int8		*dev
+)
+{
+	u_int8	curNom[CH_NUMBER], curDev[CH_NUMBER];
+	u_int8	rbNom[CH_NUMBER], rbDev[CH_NUMBER], n, wr = 0;
+	int32	error;
+
+	if( (error = CfgLoad( llHdl, BUS_CALL, curNom, curDev )) )
+		return(error);
+
+	for( n=0; n<CH_NUMBER; n++ ){
+		if( (nom[n] != curNom[n]) || (dev[n] != curDev[n]) )
+			wr++;
+	}
+
+	/* nothing to do? */
+	if( !wr )
+		return(ERR_SUCCESS);
+
+	/* invalidate the cache while the PIC is written */
+	OSS_SpinLockAcquire( llHdl->osHdl, llHdl->cfgLock );
+	llHdl->cfgValid = FALSE;
+	llHdl->cfgGen++;
+	OSS_SpinLockRelease( llHdl->osHdl, llHdl->cfgLock );
+
+	for( n=0; (n<CH_NUMBER) && !error; n++ ){
+		if( nom[n] != curNom[n] )
+			error = SmbXfer( llHdl, BUS_CALL, XFER_WR_BYTE_DATA,
+							 (u_int8)F14BCI_VOLT_NOM(n), &nom[n], 1 );
+		if( !error && (dev[n] != curDev[n]) )
+			error = SmbXfer( llHdl, BUS_CALL, XFER_WR_BYTE_DATA,
+							 (u_int8)F14BCI_VOLT_DEV(n), &dev[n], 1 );
+	}
+
+	/* verify */
+	if( !error &&
+		!(error = SmbReadBlk( llHdl, BUS_CALL, F14BCI_VOLT_NOM(0),
+							  CH_NUMBER, rbNom )) &&
+		!(error = SmbReadBlk( llHdl, BUS_CALL, F14BCI_VOLT_DEV(0),
+							  CH_NUMBER, rbDev )) ){
+		for( n=0; n<CH_NUMBER; n++ ){
+			if( (rbNom[n] != nom[n]) || (rbDev[n] != dev[n]) ){
+				DBGWRT_ERR((DBH, " *** CfgWrite: ch=%d verify failed\n", n));
+				error = ERR_LL_WRITE;
+				break;
+			}
+		}
+	}
+
+	OSS_SpinLockAcquire( llHdl->osHdl, llHdl->cfgLock );
+	if( !error ){
+		OSS_MemCopy( llHdl->osHdl, CH_NUMBER, (char*)nom,
+					 (char*)llHdl->cfgNom );
+		OSS_MemCopy( llHdl->osHdl, CH_NUMBER, (char*)dev,
+					 (char*)llHdl->cfgDev );
+		llHdl->cfgValid = TRUE;
+	}
+	llHdl->cfgGen++;
+	OSS_SpinLockRelease( llHdl->osHdl, llHdl->cfgLock );
+
+	return(error);
+}
+
+/********************************* RegRead **********************************/
+/** Read a PIC register
+ *
+ *  Nominal/deviation voltages are taken from the configuration cache.
+ *  In snapshot mode, the register value is taken from the snapshot
+ *  (if it is part of it), otherwise the register is read from the PIC.
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *  \param cmd        \IN  SMB command (F14BCI_xxx)
+ *  \param valP       \OUT Register value
+ *
+ *  \return           \c 0 On success or error code
+ */
+static int32 RegRead(
+	LL_HANDLE	*llHdl,
+	u_int8		cmd,
+	u_int8		*valP
+)
+{
+	u_int8	nom[CH_NUMBER], dev[CH_NUMBER], *snapP;
+	int32	error;
+
+	if( (snapP = CfgReg( nom, dev, cmd )) ){
+		if( (error = CfgLoad( llHdl, BUS_CALL, nom, dev )) )
+			return(error);
+		*valP = *snapP;
+		return(ERR_SUCCESS);
+	}
+
+	if( llHdl->snapMode && (snapP = SnapReg( llHdl, cmd )) ){
+		*valP = *snapP;
+		return(ERR_SUCCESS);
+	}
+
+	return( SmbXfer( llHdl, BUS_CALL, XFER_RD_BYTE_DATA, cmd, valP, 1 ) );
+}
+
+/******************************* RegReadBlk *********************************/
+/** Read a range of consecutive PIC registers
+ *
+ *  Nominal/deviation voltages are taken from the configuration cache.
+ *  In snapshot mode, the register values are taken from the snapshot
+ *  (if the range is part of it), otherwise the registers are read
+ *  from the PIC.
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *  \param cls        \IN  SMBus access class (BUS_xxx)
+ *  \param cmd        \IN  SMB command of first register (F14BCI_xxx)
+ *  \param n          \IN  Number of registers
+ *  \param buf        \OUT Register values
+ *
+ *  \return           \c 0 On success or error code
+ */
+static int32 RegReadBlk(
+	LL_HANDLE	*llHdl,
+	u_int32		cls,
+	u_int8		cmd,
+	u_int8		n,
+	u_int8		*buf
+)
+{
+	u_int8	nom[CH_NUMBER], dev[CH_NUMBER], *snapP;
+	int32	error;
+
+	if( (snapP = CfgReg( nom, dev, cmd )) &&
+		(CfgReg( nom, dev, (u_int8)(cmd + n - 1) ) == snapP + n - 1) ){
+		if( (error = CfgLoad( llHdl, cls, nom, dev )) )
+			return(error);
+		OSS_MemCopy( llHdl->osHdl, n, (char*)snapP, (char*)buf );
+		return(ERR_SUCCESS);
+	}
+
+	if( llHdl->snapMode && (snapP = SnapReg( llHdl, cmd )) &&
+		(SnapReg( llHdl, (u_int8)(cmd + n - 1) ) == snapP + n - 1) ){
+		OSS_MemCopy( llHdl->osHdl, n, (char*)snapP, (char*)buf );
+		return(ERR_SUCCESS);
+	}
+
+	return( SmbReadBlk( llHdl, cls, cmd, n, buf ) );
+}
+
+/******************************** CtrlSweep *********************************/
+/** Read the supervision registers of all controllers
+ *
+ *  The input voltages, error counters and supervision state of each
+ *  controller are read into the unused half of the double buffer, which
+ *  becomes valid after all controllers were read. A controller that
+ *  could not be read keeps its last values, the error is recorded.
+ *  A controller that was skipped because the SMBus was busy (alarm)
+ *  keeps its whole entry, as the poll retries with the next period.
+ *
+ *  The supervision poll passes this F14BC's registers it has read
+ *  anyway (own), so only the additional controllers are read here.
+ *  Without own, this F14BC's registers are taken from the snapshot
+ *  in snapshot mode, or read from the PIC.
+ *
+ *  Additional controllers are not covered by retries and the circuit
+ *  breaker, so an absent board doesn't disturb this F14BC.
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *  \param cls        \IN  SMBus access class (BUS_xxx)
+ *  \param own        \IN  this F14BC's registers and error or NULL
+ *
+ *  \return           \c 0 if all controllers were read or first error code
+ */
+static int32 CtrlSweep(
+	LL_HANDLE	*llHdl,
+	u_int32		cls,
+	CTRL_SWEEP	*own
+)
+{
+	u_int32		idx = llHdl->ctrlIdx ^ 1, i;
+	int32		error, ret = ERR_SUCCESS;
+	CTRL_DEV	*dev;
+	CTRL_SWEEP	sw;
+
+	for( i=0; i<=llHdl->ctrlNbr; i++ ){
+		dev = &llHdl->ctrl[i];
+		sw  = dev->sweep[idx ^ 1];
+
+		if( (i == 0) && own ){
+			if( !(error = own->error) ){
+				OSS_MemCopy( llHdl->osHdl, CH_NUMBER, (char*)own->voltIn,
+							 (char*)sw.voltIn );
+				OSS_MemCopy( llHdl->osHdl, ERRCNT_NUMBER, (char*)own->errCnt,
+							 (char*)sw.errCnt );
+				sw.svState = own->svState;
+				sw.tick    = own->tick;
+			}
+		}
+		else if( (i == 0) && llHdl->snapMode ){
+			SNAPSHOT *snap = &llHdl->snap[llHdl->snapIdx];
+
+			OSS_MemCopy( llHdl->osHdl, CH_NUMBER, (char*)snap->voltIn,
+						 (char*)sw.voltIn );
+			OSS_MemCopy( llHdl->osHdl, ERRCNT_NUMBER, (char*)snap->errCnt,
+						 (char*)sw.errCnt );
+			sw.svState = snap->svState;
+			sw.tick    = snap->tick;
+			error = ERR_SUCCESS;
+		}
+		else{
+			u_int8 in[CH_NUMBER], cnt[ERRCNT_NUMBER], state;
+
+			if( !(error = CtrlReadBlk( llHdl, cls, dev, F14BCI_VOLT_IN(0),
+									   CH_NUMBER, in )) &&
+				!(error = CtrlReadBlk( llHdl, cls, dev, F14BCI_ERRCNT_NO_TRIG,
+									   ERRCNT_NUMBER, cnt )) &&
+				!(error = SmbXferOnce( llHdl, cls, dev->smbH, dev->smbAddr,
+									   XFER_RD_BYTE_DATA, F14BCI_VOLT_SVSTATE,
+									   &state, 1 )) ){
+				OSS_MemCopy( llHdl->osHdl, CH_NUMBER, (char*)in,
+							 (char*)sw.voltIn );
+				OSS_MemCopy( llHdl->osHdl, ERRCNT_NUMBER, (char*)cnt,
+							 (char*)sw.errCnt );
+				sw.svState = state;
+				sw.tick    = OSS_TickGet( llHdl->osHdl );
+			}
+		}
+
+		/* SMBus busy: keep the previous entry (alarm only) */
+		if( error == ERR_OSS_BUSY ){
+			dev->sweep[idx] = dev->sweep[idx ^ 1];
+			continue;
+		}
+
+		if( error && !ret ){
+			DBGWRT_ERR((DBH, " *** CtrlSweep: ctrl %d bus=%d addr=0x%x "
+				"error=0x%x\n", i, dev->busNbr, dev->smbAddr, error));
+			ret = error;
+		}
+
+		sw.error = error;
+		dev->sweep[idx] = sw;
+	}
+
+	llHdl->ctrlIdx = idx;
+
+	return(ret);
+}
+
+/******************************* CtrlReadBlk ********************************/
+/** Read a range of consecutive registers from a controller
+ *
+ *  Like SmbReadBlk(), but for any controller and without retries.
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *  \param cls        \IN  SMBus access class (BUS_xxx)
+ *  \param dev        \IN  Controller
+ *  \param cmd        \IN  SMB command of first register (F14BCI_xxx)
+ *  \param n          \IN  Number of registers
+ *  \param buf        \OUT Register values
+ *
+ *  \return           \c 0 On success or error code
+ */
+static int32 CtrlReadBlk(
+	LL_HANDLE	*llHdl,
+	u_int32		cls,
+	CTRL_DEV	*dev,
+	u_int8		cmd,
+	u_int8		n,
+	u_int8		*buf
+)
+{
+	int32	error = ERR_SUCCESS;
+	u_int8	i;
+
+	if( dev->blkRead )
+		return( SmbXferOnce( llHdl, cls, dev->smbH, dev->smbAddr,
+							 XFER_RD_BLOCK, cmd, buf, n ) );
+
+	for( i=0; i<n; i++ ){
+		if( (error = SmbXferOnce( llHdl, cls, dev->smbH, dev->smbAddr,
+								  XFER_RD_BYTE_DATA, (u_int8)(cmd + i),
+								  &buf[i], 1 )) )
+			break;
+	}
+
+	return(error);
+}
+
+/******************************* SmbReadBlk *********************************/
+/** Read a range of consecutive PIC registers from the PIC
+ *
+ *  If block reads are enabled, the registers are read with one I2C
+ *  transfer (command byte write + n byte read, the PIC increments the
+ *  register address). Otherwise, each register is read with a separate
+ *  SMB read byte data command (the SMBus is released between the commands).
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *  \param cls        \IN  SMBus access class (BUS_xxx)
+ *  \param cmd        \IN  SMB command of first register (F14BCI_xxx)
+ *  \param n          \IN  Number of registers
+ *  \param buf        \OUT Register values
+ *
+ *  \return           \c 0 On success or error code
+ */
+static int32 SmbReadBlk(
+	LL_HANDLE	*llHdl,
+	u_int32		cls,
+	u_int8		cmd,
+	u_int8		n,
+	u_int8		*buf
+)
+{
+	int32	error = ERR_SUCCESS;
+	u_int8	i;
+
+	if( llHdl->blkRead )
+		return( SmbXfer( llHdl, cls, XFER_RD_BLOCK, cmd, buf, n ) );
+
+	for( i=0; i<n; i++ ){
+		if( (error = SmbXfer( llHdl, cls, XFER_RD_BYTE_DATA,
+							  (u_int8)(cmd + i), &buf[i], 1 )) )
+			break;
+	}
+
+	return(error);
+}
+
+/********************************* SmbXfer **********************************/
+/** Perform one SMBus transaction with the PIC
+ *
+ *  All SMBus accesses of the driver are done here. A transaction that
+ *  fails with a transient SMB2 error (bus busy, collision, no acknowledge)
+ *  is repeated up to XFER_RETRY times with a jittered exponential backoff.
+ *  The alarm handler (BUS_ALARM) never retries, it polls again with its
+ *  next period.
+ *
+ *  After BREAKER_LIMIT consecutive failed transactions, the circuit
+ *  breaker opens and all transactions fail with F14BC_ERR_NORESP without
+ *  SMBus access. Every BREAKER_TIMEOUT, one transaction probes the PIC
+ *  and closes the breaker on success. Watchdog operations always access
+ *  the SMBus.
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *  \param cls        \IN  SMBus access class (BUS_xxx)
+ *  \param op         \IN  Transaction (XFER_xxx)
+ *  \param cmd        \IN  SMB command (F14BCI_xxx)
+ *  \param data       \IN  Data to write (u_int8 or u_int16)
+ *                    \OUT Read data (u_int8, u_int16 or n bytes)
+ *  \param n          \IN  Number of bytes for XFER_RD_BLOCK
+ *
+ *  \return           \c 0 On success or error code
+ */
+static int32 SmbXfer(
+	LL_HANDLE	*llHdl,
+	u_int32		cls,
+	u_int32		op,
+	u_int8		cmd,
+	void		*data,
+	u_int8		n
+)
+{
+	u_int32	try;
+	int32	error;
+
+	/* circuit breaker open? (watchdog triggers are never suppressed) */
+	if( (cls != BUS_WDOG) && (cmd != F14BCI_WDTRIG) &&
+		(error = BreakerCheck( llHdl )) )
+		return(error);
+
+	for( try=0; ; try++ ){
+		error = SmbXferOnce( llHdl, cls, llHdl->smbH, llHdl->smbAddr,
+							 op, cmd, data, n );
+
+		if( !XFER_TRANSIENT(error) || (try >= llHdl->xferRetry) ||
+			(cls == BUS_ALARM) )
+			break;
+
+		OSS_Delay( llHdl->osHdl, XferBackoff( llHdl, try ) );
+	}
+
+	BreakerUpdate( llHdl, error );
+
+	return(error);
+}
+
+/******************************* SmbXferOnce ********************************/
+/** Perform one SMBus transaction attempt
+ *
+ *  The driver uses LL_LOCK_NONE, so the SMBus is owned only for the
+ *  duration of one transaction (see BusGet()) and calls that don't access
+ *  the SMBus are never blocked. SMB2 errors are mapped into the device
+ *  specific error code range and each transaction is counted
+ *  (see XferStat()).
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *  \param cls        \IN  SMBus access class (BUS_xxx)
+ *  \param smbH       \IN  SMB handle of the controller
+ *  \param addr       \IN  SMB address of the controller
+ *  \param op         \IN  Transaction (XFER_xxx)
+ *  \param cmd        \IN  SMB command (F14BCI_xxx)
+ *  \param data       \IN  Data to write (u_int8 or u_int16)
+ *                    \OUT Read data (u_int8, u_int16 or n bytes)
+ *  \param n          \IN  Number of bytes for XFER_RD_BLOCK
+ *
+ *  \return           \c 0 On success or error code
+ */
+static int32 SmbXferOnce(
+	LL_HANDLE	*llHdl,
+	u_int32		cls,
+	SMB_HANDLE	*smbH,
+	u_int16		addr,
+	u_int32		op,
+	u_int8		cmd,
+	void		*data,
+	u_int8		n
+)
+{
+	u_int32		tick;
+	int32		error;
+
+	if( (error = BusGet( llHdl, cls )) )
+		return(error);
+
+	tick = OSS_TickGet( llHdl->osHdl );
+
+	switch( op ){
+		case XFER_WR_BYTE:
+			error = smbH->WriteByte( smbH, 0, addr, cmd );
+			break;
+		case XFER_WR_BYTE_DATA:
+			error = smbH->WriteByteData( smbH, 0, addr, cmd, *(u_int8*)data );
+			break;
+		case XFER_RD_BYTE_DATA:
+			error = smbH->ReadByteData( smbH, 0, addr, cmd, (u_int8*)data );
+			break;
+		case XFER_WR_WORD_DATA:
+			error = smbH->WriteWordData( smbH, 0, addr, cmd, *(u_int16*)data );
+			break;
+		case XFER_RD_WORD_DATA:
+			error = smbH->ReadWordData( smbH, 0, addr, cmd, (u_int16*)data );
+			break;
+		case XFER_RD_BLOCK:
+		{
+			SMB_I2CMESSAGE msg[2];
+
+			msg[0].addr  = addr;
+			msg[0].flags = 0;
+			msg[0].len   = 1;
+			msg[0].buf   = &cmd;
+
+			msg[1].addr  = addr;
+			msg[1].flags = I2C_M_RD;
+			msg[1].len   = n;
+			msg[1].buf   = (u_int8*)data;
+
+			error = smbH->I2CXfer( smbH, msg, 2 );
+			break;
+		}
+		default:
+			error = ERR_LL_ILL_PARAM;
+	}
+
+	SMB2_ERRMAP( error );
+	XferStat( llHdl, cmd, error, OSS_TickGet(llHdl->osHdl) - tick );
+
+	BusRelease( llHdl );
+
+	return(error);
+}
+
+/******************************* XferBackoff ********************************/
+/** Get the delay before the next retry
+ *
+ *  The delay is XFER_BACKOFF * 2^try plus a random jitter of the same
+ *  size, so callers that failed together don't collide again.
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *  \param try        \IN  Number of the failed attempt (0..)
+ *
+ *  \return           delay [ms]
+ */
+static u_int32 XferBackoff(
+	LL_HANDLE	*llHdl,
+	u_int32		try
+)
+{
+	u_int32 ms = llHdl->xferBackoff << try;
+
+	OSS_SpinLockAcquire( llHdl->osHdl, llHdl->busLock );
+	llHdl->xferRetries++;
+	llHdl->xferSeed = llHdl->xferSeed * 1103515245 + 12345;
+	ms += (llHdl->xferSeed >> 16) % ms;
+	OSS_SpinLockRelease( llHdl->osHdl, llHdl->busLock );
+
+	return( ms > XFER_DELAY_MAX ? XFER_DELAY_MAX : ms );
+}
+
+/******************************* BreakerCheck *******************************/
+/** Check the circuit breaker
+ *
+ *  If the breaker is open and BREAKER_TIMEOUT elapsed, the caller may
+ *  probe the PIC. Other callers fail fast until the next timeout.
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *
+ *  \return           \c 0 if the SMBus may be accessed or F14BC_ERR_NORESP
+ */
+static int32 BreakerCheck(
+	LL_HANDLE *llHdl
+)
+{
+	int32	error = ERR_SUCCESS;
+	u_int32	now;
+
+	OSS_SpinLockAcquire( llHdl->osHdl, llHdl->busLock );
+	if( llHdl->brkOpen ){
+		now = OSS_TickGet( llHdl->osHdl );
+
+		if( TickToMs( llHdl, now - llHdl->brkTick ) >= llHdl->brkTmo )
+			llHdl->brkTick = now;	/* probe */
+		else
+			error = F14BC_ERR_NORESP;
+	}
+	OSS_SpinLockRelease( llHdl->osHdl, llHdl->busLock );
+
+	return(error);
+}
+
+/****************************** BreakerUpdate *******************************/
+/** Update the circuit breaker with a transaction result
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *  \param error      \IN  Transaction result
+ */
+static void BreakerUpdate(
+	LL_HANDLE	*llHdl,
+	int32		error
+)
+{
+	OSS_SpinLockAcquire( llHdl->osHdl, llHdl->busLock );
+	if( !error ){
+		llHdl->brkFaults = 0;
+		llHdl->brkOpen = FALSE;
+	}
+	else if( XFER_FAULT(error) && llHdl->brkLimit &&
+			 (++llHdl->brkFaults >= llHdl->brkLimit) ){
+		if( !llHdl->brkOpen ){
+			llHdl->brkOpen = TRUE;
+			llHdl->brkTrips++;
+		}
+		llHdl->brkTick = OSS_TickGet( llHdl->osHdl );
+	}
+	OSS_SpinLockRelease( llHdl->osHdl, llHdl->busLock );
+}
+
+/********************************* XferStat *********************************/
+/** Count an SMBus transaction
+ *
+ *  Must be called by the SMBus owner only (see BusGet()).
+ *
+ *  The time is kept in raw OSS ticks, a conversion to ms per transaction
+ *  would put nearly all transactions into the first histogram bin.
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *  \param cmd        \IN  SMB command (F14BCI_xxx)
+ *  \param error      \IN  Mapped transaction error (see SMB2_ERRMAP)
+ *  \param ticks      \IN  Transaction time [OSS ticks]
+ */
+static void XferStat(
+	LL_HANDLE	*llHdl,
+	u_int8		cmd,
+	int32		error,
+	u_int32		ticks
+)
+{
+	u_int32 bin;
+
+	llHdl->xferCmd[cmd]++;
+	llHdl->xferTicks += ticks;
+
+	/* SMB2 error or other error (bin 0) */
+	if( error ){
+		if( (error > ERR_DEV) && (error < ERR_DEV + XFER_ERR_NBR) )
+			llHdl->xferErr[error - ERR_DEV]++;
+		else
+			llHdl->xferErr[0]++;
+	}
+
+	/* bin n: 2^(n-1)..2^n-1 ticks, bin 0: <1 tick */
+	for( bin=0; (bin < XFER_LAT_NBR - 1) && ticks; bin++ )
+		ticks >>= 1;
+	llHdl->xferLat[bin]++;
+}
+
+/********************************** BusGet **********************************/
+/** Get the SMBus for one transaction
+ *
+ *  If the SMBus is busy, the caller is queued in its access class and
+ *  waits until BusRelease() hands the SMBus over. The alarm handler
+ *  (BUS_ALARM) never waits, it gets ERR_OSS_BUSY instead.
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *  \param cls        \IN  SMBus access class (BUS_xxx)
+ *
+ *  \return           \c 0 On success or error code
+ */
+static int32 BusGet(
+	LL_HANDLE	*llHdl,
+	u_int32		cls
+)
+{
+	BUSQ	*q = &llHdl->busq[cls];
+	u_int32	tick, ms;
+	int32	error;
+
+	OSS_SpinLockAcquire( llHdl->osHdl, llHdl->busLock );
+	q->xfers++;
+
+	/* SMBus free? */
+	if( !llHdl->busBusy ){
+		llHdl->busBusy = TRUE;
+		OSS_SpinLockRelease( llHdl->osHdl, llHdl->busLock );
+		return(ERR_SUCCESS);
+	}
+
+	q->waits++;
+	if( cls == BUS_ALARM ){
+		OSS_SpinLockRelease( llHdl->osHdl, llHdl->busLock );
+		return(ERR_OSS_BUSY);
+	}
+
+	if( ++q->waiting > q->depthMax )
+		q->depthMax = q->waiting;
+	OSS_SpinLockRelease( llHdl->osHdl, llHdl->busLock );
+
+	/* wait for the handover */
+	tick = OSS_TickGet( llHdl->osHdl );
+	if( (error = OSS_SemWait( llHdl->osHdl, q->grant, OSS_SEM_WAITFOREVER )) ){
+		/* wait aborted (e.g. signal): leave the queue */
+		OSS_SpinLockAcquire( llHdl->osHdl, llHdl->busLock );
+		if( q->waiting ){
+			q->waiting--;
+			OSS_SpinLockRelease( llHdl->osHdl, llHdl->busLock );
+			return(error);
+		}
+		OSS_SpinLockRelease( llHdl->osHdl, llHdl->busLock );
+
+		/* the SMBus was already handed over: take it and pass it on */
+		while( OSS_SemWait( llHdl->osHdl, q->grant, OSS_SEM_WAITFOREVER ) )
+			;
+		BusRelease( llHdl );
+		return(error);
+	}
+	ms = TickToMs( llHdl, OSS_TickGet(llHdl->osHdl) - tick );
+
+	OSS_SpinLockAcquire( llHdl->osHdl, llHdl->busLock );
+	q->waitSum += ms;
+	if( ms > q->waitMax )
+		q->waitMax = ms;
+	OSS_SpinLockRelease( llHdl->osHdl, llHdl->busLock );
+
+	return(ERR_SUCCESS);
+}
+
+/******************************** BusRelease ********************************/
+/** Release the SMBus after a transaction
+ *
+ *  A pending auto trigger of the watchdog is sent first. Then the SMBus
+ *  is handed over to the first waiting caller of the class with the
+ *  highest priority, so a watchdog operation waits at most for the
+ *  transaction in progress.
+ *
+ *  \param llHdl      \IN  Low-level handle
+ */
+static void BusRelease(
+	LL_HANDLE *llHdl
+)
+{
+	u_int32 cls;
+
+	OSS_SpinLockAcquire( llHdl->osHdl, llHdl->busLock );
+
+	/* pending auto trigger of the watchdog first (SMBus stays busy) */
+	while( llHdl->wdKickPend ){
+		llHdl->wdKickPend = FALSE;
+		OSS_SpinLockRelease( llHdl->osHdl, llHdl->busLock );
+		WdogKickPending( llHdl );
+		OSS_SpinLockAcquire( llHdl->osHdl, llHdl->busLock );
+	}
+
+	for( cls=0; cls<BUS_CLASS_NBR; cls++ ){
+		if( llHdl->busq[cls].waiting ){
+			llHdl->busq[cls].waiting--;
+			break;
+		}
+	}
+
+	/* nobody waiting? */
+	if( cls == BUS_CLASS_NBR )
+		llHdl->busBusy = FALSE;
+	OSS_SpinLockRelease( llHdl->osHdl, llHdl->busLock );
+
+	/* hand over (SMBus stays busy) */
+	if( cls < BUS_CLASS_NBR )
+		OSS_SemSignal( llHdl->osHdl, llHdl->busq[cls].grant );
+}
+
+/********************************* TickToMs *********************************/
+/** Convert a number of OSS ticks into milliseconds
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *  \param ticks      \IN  Number of ticks
+ *
+ *  \return           milliseconds
+ */
+static u_int32 TickToMs(
+	LL_HANDLE	*llHdl,
+	u_int32		ticks
+)
+{
+	u_int32 rate = OSS_TickRateGet( llHdl->osHdl );
+
+	return( (ticks / rate) * 1000 + ((ticks % rate) * 1000) / rate );
+}
+
+/********************************* SvEvtPut *********************************/
+/** Put a supervision event into the event ring
+ *
+ *  Called from the alarm handler only. The ring is guarded by svEvtLock,
+ *  so a reader never sees the index before the event data. If the ring
+ *  is full, the event is dropped and counted as lost.
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *  \param type       \IN  Event type (F14BC_SVEVT_xxx)
+ *  \param state      \IN  New state bitmask
+ */
+static void SvEvtPut(
+	LL_HANDLE	*llHdl,
+	u_int8		type,
+	u_int8		state
+)
+{
+	u_int32 in, tick = OSS_TickGet( llHdl->osHdl );
+	SVEVENT *evt;
+
+	OSS_SpinLockAcquire( llHdl->osHdl, llHdl->svEvtLock );
+
+	in = llHdl->svEvtIn;
+	if( in - llHdl->svEvtOut >= SVEVT_RING_SIZE ){
+		llHdl->svEvtLost++;
+		OSS_SpinLockRelease( llHdl->osHdl, llHdl->svEvtLock );
+		return;
+	}
+
+	evt = &llHdl->svEvt[in & (SVEVT_RING_SIZE - 1)];
+	evt->tick  = tick;
+	evt->type  = type;
+	evt->state = state;
+
+	/* publish the event */
+	llHdl->svEvtIn = in + 1;
+
+	OSS_SpinLockRelease( llHdl->osHdl, llHdl->svEvtLock );
+
+	/* wake a waiting F14BC_BlockRead */
+	if( llHdl->svEvtTout )
+		OSS_SemSignal( llHdl->osHdl, llHdl->svEvtSem );
+}
+
+/********************************* SvEvtGet *********************************/
+/** Get supervision events from the event ring
+ *
+ *  Called from the driver's entry points only. The ring is guarded by
+ *  svEvtLock (not ctrlSem), so readers never wait for a Setstat.
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *  \param evt        \OUT Event buffer
+ *  \param nbr        \IN  Max. number of events to get
+ *
+ *  \return           number of events
+ */
+static int32 SvEvtGet(
+	LL_HANDLE		*llHdl,
+	F14BC_SVEVENT	*evt,
+	int32			nbr
+)
+{
+	u_int32 out, in;
+	int32	n;
+	SVEVENT	*ring;
+
+	OSS_SpinLockAcquire( llHdl->osHdl, llHdl->svEvtLock );
+
+	out = llHdl->svEvtOut;
+	in  = llHdl->svEvtIn;
+
+	for( n=0; (n<nbr) && (out != in); n++, out++ ){
+		ring = &llHdl->svEvt[out & (SVEVT_RING_SIZE - 1)];
+		evt[n].time  = TickToMs( llHdl, ring->tick - llHdl->initTick );
+		evt[n].type  = ring->type;
+		evt[n].state = ring->state;
+	}
+
+	/* release the slots */
+	llHdl->svEvtOut = out;
+
+	OSS_SpinLockRelease( llHdl->osHdl, llHdl->svEvtLock );
+
+	return(n);
+}
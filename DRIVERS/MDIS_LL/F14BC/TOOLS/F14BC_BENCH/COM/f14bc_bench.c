@@ -0,0 +1,396 @@
+/****************************************************************************
+ ************                                                    ************
+ ************                    F14BC_BENCH                     ************
+ ************                                                    ************
+ ****************************************************************************/
+/*!
+ *         \file f14bc_bench.c
+ *       \author dieter.pfeuffer@men.de
+ *
+ *        \brief Host benchmark for the F14BC low-level driver
+ *
+ *  Runs the F14BC driver (compiled into this program) against a
+ *  simulated F14BC (see f14bc_sim.c) through the LL_ENTRY table of
+ *  __F14BC_GetEntry(). No MDIS kernel and no hardware is required.
+ *
+ *  For each operation, the benchmark reports the host CPU time per call,
+ *  the number of SMBus transactions per call and the simulated bus time
+ *  per call. It runs with the default descriptor and again with
+ *  BLOCK_READ and SNAPSHOT_MODE, and finally measures the watchdog
+ *  trigger latency while the alarm polls the voltage supervision.
+ *  Times on the simulated bus are virtual, so the results are
+ *  reproducible on any host.
+ *
+ *     Required: libraries: usr_oss, usr_utl
+ *     \switches (none)
+ */
+ /*
+ *---------------------------------------------------------------------------
+ * Copyright 2019, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+/*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/* the driver under test */
+#include "../../../DRIVER/COM/f14bc_drv.c"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <MEN/usr_oss.h>
+#include <MEN/usr_utl.h>
+#include "f14bc_sim.h"
+
+static const char BenchIdentString[]=MENT_XSTR(MAK_REVISION);
+
+/*--------------------------------------+
+|   DEFINES                             |
++--------------------------------------*/
+#define SMB_ADDR		0x9a	/**< SMB address of simulated F14BC */
+#define LOAD_POLL_MS	50		/**< poll period for latency test [ms] */
+
+/* operation types */
+#define OP_GET			0		/**< getstat */
+#define OP_GETBLK		1		/**< block getstat */
+#define OP_SET			2		/**< setstat */
+
+/*--------------------------------------+
+|   TYPEDEFS                            |
++--------------------------------------*/
+/** benchmarked operation */
+typedef struct {
+	char	*name;		/**< name */
+	int32	type;		/**< OP_xxx */
+	int32	code;		/**< status code */
+	int32	ch;			/**< channel */
+	int32	value;		/**< setstat value */
+} BENCH_OP;
+
+/*--------------------------------------+
+|   GLOBALS                             |
++--------------------------------------*/
+static LL_ENTRY	G_entry;
+static u_int8	G_blkBuf[sizeof(F14BC_XFER_STAT)];
+static F14BC_MULTI G_multi[CH_NUMBER];
+
+static const BENCH_OP G_op[] = {
+	{ "WDOG_STATUS",          OP_GET,    WDOG_STATUS,          0, 0 },
+	{ "WDOG_TRIG",            OP_SET,    WDOG_TRIG,            0, 0 },
+	{ "F14BC_VOLT_IN",        OP_GET,    F14BC_VOLT_IN,        0, 0 },
+	{ "F14BC_VOLT_NOM",       OP_GET,    F14BC_VOLT_NOM,       0, 0 },
+	{ "F14BC_ERRCNT_WDOG",    OP_GET,    F14BC_ERRCNT_WDOG,    0, 0 },
+	{ "F14BC_BLK_VOLT_ALL",   OP_GETBLK, F14BC_BLK_VOLT_ALL,   0,
+	  CH_NUMBER * sizeof(F14BC_VOLT) },
+	{ "F14BC_BLK_ERRCNT_ALL", OP_GETBLK, F14BC_BLK_ERRCNT_ALL, 0,
+	  ERRCNT_NUMBER },
+	{ "F14BC_BLK_FWREV",      OP_GETBLK, F14BC_BLK_FWREV,      0,
+	  F14BCI_REV_BYTESIZE },
+	{ "F14BC_BLK_MULTI (7xIN)", OP_GETBLK, F14BC_BLK_MULTI,    0,
+	  sizeof(G_multi) },
+	{ NULL, 0, 0, 0, 0 }
+};
+
+/*--------------------------------------+
+|   PROTOTYPES                          |
++--------------------------------------*/
+static void usage(void);
+static int32 BenchOpen(LL_HANDLE **llHdlP, char *info, char *name);
+static int32 BenchOps(char *info, u_int32 nbr);
+static int32 BenchWdogLatency(u_int32 nbr);
+static int32 OpRun(LL_HANDLE *llHdl, const BENCH_OP *op);
+
+/********************************* usage ***********************************/
+/**  Print program usage
+ */
+static void usage(void)
+{
+	printf("Usage: f14bc_bench [<opts>]\n");
+	printf("Function: Benchmark the F14BC driver against a simulated F14BC\n");
+	printf("Options:\n");
+	printf("    -n=<nbr>     calls per operation                 [100000]\n");
+	printf("    -l=<us>      simulated latency per transaction   [100]\n");
+	printf("    -y=<us>      simulated latency per data byte     [20]\n");
+	printf("    -f=<n>       fail every n-th transaction         [0=off]\n");
+	printf("    -e=<err>     SMB2 error code of failures         [%d]\n",
+		   SMB_ERR_BUSY);
+	printf("\n");
+	printf("Copyright 2019, MEN Mikro Elektronik GmbH\n%s\n",
+		   BenchIdentString);
+}
+
+/********************************* main ************************************/
+/** Program main function
+ *
+ *  \param argc       \IN  argument counter
+ *  \param argv       \IN  argument vector
+ *
+ *  \return	          success (0) or error (1)
+ */
+int main( int argc, char *argv[])
+{
+	char	*str, *errstr, buf[40];
+	u_int32	nbr, n;
+
+	/*--------------------+
+    |  check arguments    |
+    +--------------------*/
+	if( (errstr = UTL_ILLIOPT("n=l=y=f=e=?", buf)) ){	/* check args */
+		printf("*** %s\n", errstr);
+		return(1);
+	}
+
+	if( UTL_TSTOPT("?") ){						/* help requested ? */
+		usage();
+		return(1);
+	}
+
+	/*--------------------+
+    |  get arguments      |
+    +--------------------*/
+	nbr = ((str = UTL_TSTOPT("n=")) ? atoi(str) : 100000);
+	G_simBus.latUs      = ((str = UTL_TSTOPT("l=")) ? atoi(str) : 100);
+	G_simBus.byteUs     = ((str = UTL_TSTOPT("y=")) ? atoi(str) : 20);
+	G_simBus.faultEvery = ((str = UTL_TSTOPT("f=")) ? atoi(str) : 0);
+	G_simBus.faultErr   = ((str = UTL_TSTOPT("e=")) ? atoi(str) : SMB_ERR_BUSY);
+
+	if( !nbr ){
+		usage();
+		return(1);
+	}
+
+	/*--------------------+
+    |  prepare            |
+    +--------------------*/
+	__F14BC_GetEntry( &G_entry );
+
+	if( SIM_DevAdd( SMB_ADDR, 1 ) == NULL )
+		return(1);
+
+	for( n=0; n<CH_NUMBER; n++ ){
+		G_multi[n].code = F14BC_VOLT_IN;
+		G_multi[n].ch   = n;
+	}
+
+	printf("simulated SMBus: %dus/transaction + %dus/byte, ",
+		   G_simBus.latUs, G_simBus.byteUs);
+	if( G_simBus.faultEvery )
+		printf("fault every %d transactions\n", G_simBus.faultEvery);
+	else
+		printf("no faults\n");
+
+	/*--------------------+
+    |  run benchmarks     |
+    +--------------------*/
+	SIM_DescClr();
+	SIM_DescSet( "SMB_BUSNBR", 0 );
+	SIM_DescSet( "SMB_DEVADDR", SMB_ADDR );
+	if( BenchOps( "default descriptor", nbr ) )
+		return(1);
+
+	SIM_DescSet( "BLOCK_READ", 1 );
+	if( BenchOps( "BLOCK_READ=1", nbr ) )
+		return(1);
+
+	SIM_DescSet( "SNAPSHOT_MODE", 1 );
+	if( BenchOps( "BLOCK_READ=1 SNAPSHOT_MODE=1", nbr ) )
+		return(1);
+
+	SIM_DescSet( "SNAPSHOT_MODE", 0 );
+	if( BenchWdogLatency( nbr ) )
+		return(1);
+
+	return(0);
+}
+
+/******************************* BenchOpen *********************************/
+/** Open the driver and print the transactions required by F14BC_Init
+ *
+ *  \param llHdlP     \OUT low-level handle
+ *  \param info       \IN  info string
+ *  \param name       \IN  name of the open in the result table
+ *
+ *  \return	          success (0) or error (1)
+ */
+static int32 BenchOpen(
+	LL_HANDLE	**llHdlP,
+	char		*info,
+	char		*name
+)
+{
+	int32 error;
+
+	SIM_CountClr();
+
+	if( (error = G_entry.init( NULL, NULL, NULL, NULL, NULL, llHdlP )) ){
+		printf("*** %s: init failed, error=0x%04x\n", info, error);
+		return(1);
+	}
+
+	printf("%-26s %10s %10d %10d\n", name, "-",
+		   G_simBus.xfers, G_simBus.busUs);
+
+	return(0);
+}
+
+/******************************** BenchOps *********************************/
+/** Run all operations with the current descriptor
+ *
+ *  \param info       \IN  description of the descriptor
+ *  \param nbr        \IN  calls per operation
+ *
+ *  \return	          success (0) or error (1)
+ */
+static int32 BenchOps(
+	char		*info,
+	u_int32		nbr
+)
+{
+	LL_HANDLE		*llHdl;
+	const BENCH_OP	*op;
+	u_int32			n, ms, fails;
+
+	printf("\n--- %s ---\n", info);
+	printf("%-26s %10s %10s %10s %8s\n", "operation", "host[ns]",
+		   "xfers", "bus[us]", "fails");
+
+	/*
+	 * the first open since program start probes the firmware rev.,
+	 * later opens use the cache and only read the watchdog state
+	 */
+	if( BenchOpen( &llHdl, info, "F14BC_Init" ) )
+		return(1);
+	G_entry.exit( &llHdl );
+	if( BenchOpen( &llHdl, info, "F14BC_Init (2nd open)" ) )
+		return(1);
+
+	/* WDOG_TRIG requires a running watchdog */
+	if( G_entry.setStat( llHdl, WDOG_START, 0, 0 ) ){
+		printf("*** %s: WDOG_START failed\n", info);
+		G_entry.exit( &llHdl );
+		return(1);
+	}
+
+	for( op=G_op; op->name; op++ ){
+		SIM_CountClr();
+		fails = 0;
+
+		ms = UOS_MsecTimerGet();
+		for( n=0; n<nbr; n++ ){
+			if( OpRun( llHdl, op ) )
+				fails++;
+		}
+		ms = UOS_MsecTimerGet() - ms;
+
+		printf("%-26s %10d %10.2f %10.1f %8d\n", op->name,
+			   (int)(((double)ms * 1000000.0) / nbr),
+			   (double)G_simBus.xfers / nbr,
+			   (double)G_simBus.busUs / nbr, fails);
+	}
+
+	G_entry.setStat( llHdl, WDOG_STOP, 0, 0 );
+	G_entry.exit( &llHdl );
+	return(0);
+}
+
+/**************************** BenchWdogLatency *****************************/
+/** Measure the watchdog trigger latency under supervision load
+ *
+ *  Between two triggers, the alarm polls the voltage supervision for one
+ *  poll period (with history and software thresholds) and the application
+ *  reads all voltages. The latency is the simulated time of one WDOG_TRIG
+ *  call, including retries.
+ *
+ *  \param nbr        \IN  number of triggers
+ *
+ *  \return	          success (0) or error (1)
+ */
+static int32 BenchWdogLatency(
+	u_int32		nbr
+)
+{
+	static const BENCH_OP trig = { "WDOG_TRIG", OP_SET, WDOG_TRIG, 0, 0 };
+	static const BENCH_OP load = { "F14BC_BLK_VOLT_ALL", OP_GETBLK,
+		F14BC_BLK_VOLT_ALL, 0, CH_NUMBER * sizeof(F14BC_VOLT) };
+	LL_HANDLE	*llHdl;
+	u_int32		n, us, usMax = 0, usSum = 0, fails = 0;
+
+	printf("\n--- watchdog trigger latency under load ---\n");
+
+	SIM_DescSet( "POLL_PERIOD", LOAD_POLL_MS );
+	SIM_DescSet( "HISTORY_SIZE", 64 );
+	if( BenchOpen( &llHdl, "latency", "F14BC_Init" ) )
+		return(1);
+
+	if( G_entry.setStat( llHdl, F14BC_VOLT_WARN_LO, 0, 3200 ) ||
+		G_entry.setStat( llHdl, F14BC_VOLT_POLL, 0, 1 ) ||
+		G_entry.setStat( llHdl, WDOG_START, 0, 0 ) ){
+		printf("*** latency: setup failed\n");
+		G_entry.exit( &llHdl );
+		return(1);
+	}
+
+	SIM_CountClr();
+	for( n=0; n<nbr; n++ ){
+		SIM_AlarmRun( LOAD_POLL_MS );
+		OpRun( llHdl, &load );
+
+		us = SIM_TimeUs();
+		if( OpRun( llHdl, &trig ) )
+			fails++;
+		us = SIM_TimeUs() - us;
+
+		usSum += us;
+		if( us > usMax )
+			usMax = us;
+	}
+
+	printf("triggers: %d, failed: %d, latency avg: %.1fus, max: %dus\n",
+		   nbr, fails, (double)usSum / nbr, usMax);
+	printf("transactions: %d (%d injected faults)\n",
+		   G_simBus.xfers, G_simBus.faults);
+
+	G_entry.setStat( llHdl, WDOG_STOP, 0, 0 );
+	G_entry.exit( &llHdl );
+	return(0);
+}
+
+/********************************* OpRun ***********************************/
+/** Perform one operation
+ *
+ *  \param llHdl      \IN  low-level handle
+ *  \param op         \IN  operation
+ *
+ *  \return	          error code of the driver
+ */
+static int32 OpRun(
+	LL_HANDLE		*llHdl,
+	const BENCH_OP	*op
+)
+{
+	INT32_OR_64	value;
+	M_SG_BLOCK	blk;
+
+	switch( op->type ){
+		case OP_GET:
+			return( G_entry.getStat( llHdl, op->code, op->ch, &value ) );
+		case OP_GETBLK:
+			blk.size = op->value;
+			blk.data = (op->code == F14BC_BLK_MULTI) ?
+						(void*)G_multi : (void*)G_blkBuf;
+			return( G_entry.getStat( llHdl, op->code, op->ch,
+									 (INT32_OR_64*)&blk ) );
+		default:
+			return( G_entry.setStat( llHdl, op->code, op->ch, op->value ) );
+	}
+}
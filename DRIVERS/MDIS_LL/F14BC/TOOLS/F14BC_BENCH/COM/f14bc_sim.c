@@ -0,0 +1,807 @@
+/*********************  P r o g r a m  -  M o d u l e ***********************/
+/*!
+ *        \file  f14bc_sim.c
+ *
+ *      \author  dieter.pfeuffer@men.de
+ *
+ *      \brief   Simulated F14BC on a simulated SMB2 controller
+ *
+ *  Emulates the F14BC register map (see f14bci.h) behind an SMB_HANDLE
+ *  and provides host stand-ins for the OSS and DESC functions used by
+ *  the F14BC low-level driver, so the driver can run as part of a host
+ *  program.
+ *
+ *  The simulation runs on a virtual clock: each SMBus transaction and
+ *  each OSS_Delay() advances it, OSS_TickGet() returns it in ms and
+ *  SIM_AlarmRun() fires the driver's alarm in virtual time. All
+ *  functions are single threaded, so the SMBus is never found busy.
+ *
+ *     Required: -
+ *     \switches (none)
+ */
+ /*
+ *---------------------------------------------------------------------------
+ * Copyright 2019, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+/*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <MEN/men_typs.h>
+#include <MEN/oss.h>
+#include <MEN/desc.h>
+#include <MEN/mdis_err.h>
+#include <MEN/smb2.h>
+#include <MEN/f14bci.h>
+#include "f14bc_sim.h"
+
+/*--------------------------------------+
+|   DEFINES                             |
++--------------------------------------*/
+#define SEM_MAX			8		/**< max. semaphores */
+#define SPINL_MAX		4		/**< max. spin locks */
+#define ALARM_RUN_MAX	100000	/**< max. alarm calls per SIM_AlarmRun */
+
+/*--------------------------------------+
+|   TYPEDEFS                            |
++--------------------------------------*/
+/** simulated OSS alarm */
+typedef struct {
+	void	(*funct)(void *arg);	/**< alarm handler */
+	void	*arg;					/**< handler argument */
+	u_int8	used;					/**< alarm created */
+	u_int8	active;					/**< alarm set */
+	u_int32	periodUs;				/**< period [us] */
+	u_int32	nextUs;					/**< virtual time of next call [us] */
+} SIM_ALARM;
+
+/** simulated OSS semaphore */
+typedef struct {
+	u_int8	used;			/**< semaphore created */
+	int32	cnt;			/**< semaphore count */
+} SIM_SEM;
+
+/** descriptor key */
+typedef struct {
+	char	key[SIM_KEY_LEN];	/**< key name */
+	u_int32	value;				/**< key value */
+} SIM_DESC;
+
+/*--------------------------------------+
+|   GLOBALS                             |
++--------------------------------------*/
+SIM_BUS G_simBus;
+u_int32 G_simSigs;
+
+static u_int32		G_timeUs;				/* virtual clock [us] */
+static SIM_ALARM	G_alarm;				/* the driver's alarm */
+static SIM_SEM		G_sem[SEM_MAX];			/* semaphores */
+static int32		G_spinl[SPINL_MAX];		/* spin locks (dummies) */
+static SIM_DESC		G_desc[SIM_DESC_MAX];	/* descriptor */
+static u_int32		G_descNbr;				/* number of descriptor keys */
+static SMB_HANDLE	G_smbH;					/* simulated SMB2 controller */
+static int32		G_sig;					/* signal object (dummy) */
+
+/*--------------------------------------+
+|   PROTOTYPES                          |
++--------------------------------------*/
+static int32 SimXfer(u_int16 addr, u_int8 cmd, u_int32 bytes, SIM_DEV **devP);
+static u_int8 SimRead(SIM_DEV *dev, u_int8 cmd);
+
+/******************************** SIM_DevAdd ********************************/
+/** Add a simulated F14BC to the SMBus
+ *
+ *  The F14BC starts with five supervised voltages at their nominal value,
+ *  a stopped watchdog (10s) and cleared error counters.
+ *
+ *  \param smbAddr    \IN  SMB address
+ *  \param fw2        \IN  1: firmware rev. 2.0 or later, 0: rev. 1.x
+ *
+ *  \return           simulated F14BC or NULL if no free entry
+ */
+SIM_DEV *SIM_DevAdd(
+	u_int16	smbAddr,
+	u_int32	fw2
+)
+{
+	static const u_int8 nom[F14BCI_VOLT_NBR] = { 132, 200, 60, 72, 48, 0, 0 };
+	static const u_int8 dev[F14BCI_VOLT_NBR] = {   8,  10,  4,  4,  3, 0, 0 };
+	static const char	rev[] = "020100";
+	SIM_DEV	*sim = NULL;
+	u_int32	n;
+
+	for( n=0; n<SIM_DEV_MAX; n++ ){
+		if( !G_simBus.dev[n].smbAddr ){
+			sim = &G_simBus.dev[n];
+			break;
+		}
+	}
+	if( !sim )
+		return(NULL);
+
+	memset( sim, 0, sizeof(SIM_DEV) );
+	sim->smbAddr = smbAddr;
+	sim->fw2     = (u_int8)fw2;
+	sim->wdTime  = 100;
+
+	for( n=0; n<F14BCI_VOLT_NBR; n++ ){
+		sim->reg[F14BCI_VOLT_NOM(n)] = nom[n];
+		sim->reg[F14BCI_VOLT_DEV(n)] = dev[n];
+		sim->reg[F14BCI_VOLT_IN(n)]  = nom[n];
+	}
+
+	/* rev. 1.x doesn't report an ascii revision */
+	for( n=0; n<F14BCI_REV_BYTESIZE; n++ )
+		sim->reg[F14BCI_GETREV(n)] = fw2 ? (u_int8)rev[n] : 0xff;
+
+	return(sim);
+}
+
+/******************************* SIM_CountClr *******************************/
+/** Clear the SMBus counters
+ */
+void SIM_CountClr(void)
+{
+	G_simBus.xfers  = 0;
+	G_simBus.faults = 0;
+	G_simBus.busUs  = 0;
+	memset( G_simBus.xferCmd, 0, sizeof(G_simBus.xferCmd) );
+}
+
+/******************************** SIM_TimeUs ********************************/
+/** Get the virtual clock
+ *
+ *  \return           virtual time [us]
+ */
+u_int32 SIM_TimeUs(void)
+{
+	return(G_timeUs);
+}
+
+/******************************* SIM_TimeAdd ********************************/
+/** Advance the virtual clock (without firing the alarm)
+ *
+ *  \param us         \IN  time [us]
+ */
+void SIM_TimeAdd(
+	u_int32	us
+)
+{
+	G_timeUs += us;
+}
+
+/******************************* SIM_AlarmRun *******************************/
+/** Advance the virtual clock and fire the alarm when due
+ *
+ *  \param ms         \IN  time [ms]
+ */
+void SIM_AlarmRun(
+	u_int32	ms
+)
+{
+	u_int32 endUs = G_timeUs + ms * 1000, n;
+
+	for( n=0; n<ALARM_RUN_MAX; n++ ){
+		if( !G_alarm.active || ((int32)(G_alarm.nextUs - endUs) > 0) )
+			break;
+
+		if( (int32)(G_alarm.nextUs - G_timeUs) > 0 )
+			G_timeUs = G_alarm.nextUs;
+		G_alarm.nextUs += G_alarm.periodUs;
+
+		G_alarm.funct( G_alarm.arg );
+	}
+
+	if( (int32)(endUs - G_timeUs) > 0 )
+		G_timeUs = endUs;
+}
+
+/******************************* SIM_DescClr ********************************/
+/** Remove all descriptor keys
+ */
+void SIM_DescClr(void)
+{
+	G_descNbr = 0;
+}
+
+/******************************* SIM_DescSet ********************************/
+/** Set a descriptor key
+ *
+ *  \param key        \IN  key name (e.g. "SMB_BUSNBR" or "CTRL_1/SMB_DEVADDR")
+ *  \param value      \IN  key value
+ */
+void SIM_DescSet(
+	char	*key,
+	u_int32	value
+)
+{
+	u_int32 n;
+
+	for( n=0; n<G_descNbr; n++ ){
+		if( !strcmp( G_desc[n].key, key ) )
+			break;
+	}
+
+	if( n == G_descNbr ){
+		if( G_descNbr == SIM_DESC_MAX )
+			return;
+		strncpy( G_desc[n].key, key, SIM_KEY_LEN - 1 );
+		G_descNbr++;
+	}
+
+	G_desc[n].value = value;
+}
+
+/*--------------------------------------+
+|   simulated SMB2 controller           |
++--------------------------------------*/
+/********************************* SimXfer **********************************/
+/** Account one SMBus transaction
+ *
+ *  Advances the virtual clock, counts the transaction and injects faults.
+ *
+ *  \param addr       \IN  SMB address
+ *  \param cmd        \IN  SMB command
+ *  \param bytes      \IN  number of data bytes
+ *  \param devP       \OUT addressed F14BC
+ *
+ *  \return           0 or SMB_ERR_xxx
+ */
+static int32 SimXfer(
+	u_int16		addr,
+	u_int8		cmd,
+	u_int32		bytes,
+	SIM_DEV		**devP
+)
+{
+	u_int32 us = G_simBus.latUs + bytes * G_simBus.byteUs, n;
+
+	G_simBus.xfers++;
+	G_simBus.xferCmd[cmd]++;
+	G_simBus.busUs += us;
+	G_timeUs += us;
+
+	if( G_simBus.faultEvery && !(G_simBus.xfers % G_simBus.faultEvery) ){
+		G_simBus.faults++;
+		return(G_simBus.faultErr);
+	}
+
+	for( n=0; n<SIM_DEV_MAX; n++ ){
+		if( G_simBus.dev[n].smbAddr && (G_simBus.dev[n].smbAddr == addr) ){
+			*devP = &G_simBus.dev[n];
+			return(SMB_ERR_NO);
+		}
+	}
+
+	return(SMB_ERR_NO_DEVICE);
+}
+
+/********************************* SimRead **********************************/
+/** Read a byte register of a simulated F14BC
+ *
+ *  \param dev        \IN  simulated F14BC
+ *  \param cmd        \IN  SMB command (F14BCI_xxx)
+ *
+ *  \return           register value
+ */
+static u_int8 SimRead(
+	SIM_DEV		*dev,
+	u_int8		cmd
+)
+{
+	u_int8	state = 0, in, nom, diff;
+	u_int32	n;
+
+	switch( cmd ){
+		case F14BCI_WDSTATE:
+			return(dev->wdOn);
+		case F14BCI_VOLT_SVSTATE:
+			for( n=0; n<F14BCI_VOLT_NBR; n++ ){
+				in   = dev->reg[F14BCI_VOLT_IN(n)];
+				nom  = dev->reg[F14BCI_VOLT_NOM(n)];
+				diff = (in > nom) ? in - nom : nom - in;
+
+				if( nom && (diff > dev->reg[F14BCI_VOLT_DEV(n)]) )
+					state |= (u_int8)(1 << n);
+			}
+			return(state);
+		default:
+			return(dev->reg[cmd]);
+	}
+}
+
+/*
+ * SMB_HANDLE functions (see smb2.h), only the transactions
+ * used by the F14BC driver are simulated
+ */
+static int32 SimWriteByte(
+	void		*smbHdl,
+	u_int32		flags,
+	u_int16		addr,
+	u_int8		data
+)
+{
+	SIM_DEV	*dev;
+	int32	error;
+
+	if( (error = SimXfer( addr, data, 0, &dev )) )
+		return(error);
+
+	switch( data ){
+		case F14BCI_WDON:		dev->wdOn = 1;		break;
+		case F14BCI_WDOFF:		dev->wdOn = 0;		break;
+		case F14BCI_WDTRIG:		dev->wdTrigs++;		break;
+		case F14BCI_SWRESET:	dev->resets++;		break;
+		case F14BCI_ERRCNT_CLR:
+			memset( &dev->reg[F14BCI_ERRCNT_NO_TRIG], 0, F14BCI_ERRCNT_NBR );
+			break;
+		default:
+			return(SMB_ERR_PARAM);
+	}
+
+	return(SMB_ERR_NO);
+}
+
+static int32 SimWriteByteData(
+	void		*smbHdl,
+	u_int32		flags,
+	u_int16		addr,
+	u_int8		cmd,
+	u_int8		data
+)
+{
+	SIM_DEV	*dev;
+	int32	error;
+
+	if( (error = SimXfer( addr, cmd, 1, &dev )) )
+		return(error);
+
+	if( (cmd == F14BCI_WDOFF) && (data == F14BCI_WDOFF_BYTE) )
+		dev->wdOn = 0;
+	else if( ((cmd >= F14BCI_VOLT_NOM(0)) &&
+			  (cmd < F14BCI_VOLT_NOM(F14BCI_VOLT_NBR))) ||
+			 ((cmd >= F14BCI_VOLT_DEV(0)) &&
+			  (cmd < F14BCI_VOLT_DEV(F14BCI_VOLT_NBR))) )
+		dev->reg[cmd] = data;
+	else
+		return(SMB_ERR_PARAM);
+
+	return(SMB_ERR_NO);
+}
+
+static int32 SimReadByteData(
+	void		*smbHdl,
+	u_int32		flags,
+	u_int16		addr,
+	u_int8		cmd,
+	u_int8		*dataP
+)
+{
+	SIM_DEV	*dev;
+	int32	error;
+
+	if( (error = SimXfer( addr, cmd, 1, &dev )) )
+		return(error);
+
+	*dataP = SimRead( dev, cmd );
+	return(SMB_ERR_NO);
+}
+
+static int32 SimWriteWordData(
+	void		*smbHdl,
+	u_int32		flags,
+	u_int16		addr,
+	u_int8		cmd,
+	u_int16		data
+)
+{
+	SIM_DEV	*dev;
+	int32	error;
+
+	if( (error = SimXfer( addr, cmd, 2, &dev )) )
+		return(error);
+
+	if( cmd == F14BCI_WDTIME )
+		dev->wdTime = data;
+	else if( (cmd == F14BCI_SWRESET) && (data == F14BCI_SWRESET_WORD) )
+		dev->resets++;
+	else
+		return(SMB_ERR_PARAM);
+
+	return(SMB_ERR_NO);
+}
+
+static int32 SimReadWordData(
+	void		*smbHdl,
+	u_int32		flags,
+	u_int16		addr,
+	u_int8		cmd,
+	u_int16		*dataP
+)
+{
+	SIM_DEV	*dev;
+	int32	error;
+
+	if( (error = SimXfer( addr, cmd, 2, &dev )) )
+		return(error);
+
+	if( cmd != F14BCI_WDTIME )
+		return(SMB_ERR_PARAM);
+
+	*dataP = dev->wdTime;
+	return(SMB_ERR_NO);
+}
+
+static int32 SimI2CXfer(
+	void			*smbHdl,
+	SMB_I2CMESSAGE	msg[],
+	u_int32			num
+)
+{
+	SIM_DEV	*dev;
+	int32	error;
+	u_int8	cmd;
+	u_int16	i;
+
+	/* only command byte write + n byte read */
+	if( (num != 2) || (msg[0].flags & I2C_M_RD) || (msg[0].len != 1) ||
+		!(msg[1].flags & I2C_M_RD) )
+		return(SMB_ERR_PARAM);
+
+	cmd = msg[0].buf[0];
+	if( (error = SimXfer( msg[0].addr, cmd, msg[1].len, &dev )) )
+		return(error);
+
+	/* the PIC increments the register address */
+	for( i=0; i<msg[1].len; i++ )
+		msg[1].buf[i] = SimRead( dev, (u_int8)(cmd + i) );
+
+	return(SMB_ERR_NO);
+}
+
+/*--------------------------------------+
+|   OSS stand-ins                       |
++--------------------------------------*/
+char *OSS_Ident( void )
+{
+	return("F14BC_SIM OSS");
+}
+
+void *OSS_MemGet(
+	OSS_HANDLE	*osHdl,
+	u_int32		size,
+	u_int32		*gotsizeP
+)
+{
+	*gotsizeP = size;
+	return( malloc( size ) );
+}
+
+int32 OSS_MemFree(
+	OSS_HANDLE	*osHdl,
+	void		*addr,
+	u_int32		size
+)
+{
+	free( addr );
+	return(0);
+}
+
+void OSS_MemFill(
+	OSS_HANDLE	*osHdl,
+	u_int32		size,
+	char		*adr,
+	int8		value
+)
+{
+	memset( adr, value, size );
+}
+
+void OSS_MemCopy(
+	OSS_HANDLE	*osHdl,
+	u_int32		size,
+	char		*src,
+	char		*dest
+)
+{
+	memmove( dest, src, size );
+}
+
+int32 OSS_AlarmCreate(
+	OSS_HANDLE			*osHdl,
+	void				(*funct)(void *arg),
+	void				*arg,
+	OSS_ALARM_HANDLE	**alarmP
+)
+{
+	if( G_alarm.used )
+		return(ERR_OSS_MEM_ALLOC);
+
+	memset( &G_alarm, 0, sizeof(G_alarm) );
+	G_alarm.used  = TRUE;
+	G_alarm.funct = funct;
+	G_alarm.arg   = arg;
+	*alarmP = (OSS_ALARM_HANDLE*)&G_alarm;
+	return(0);
+}
+
+int32 OSS_AlarmRemove(
+	OSS_HANDLE			*osHdl,
+	OSS_ALARM_HANDLE	**alarmP
+)
+{
+	G_alarm.used   = FALSE;
+	G_alarm.active = FALSE;
+	*alarmP = NULL;
+	return(0);
+}
+
+int32 OSS_AlarmSet(
+	OSS_HANDLE			*osHdl,
+	OSS_ALARM_HANDLE	*alarm,
+	u_int32				msec,
+	u_int32				cyclic,
+	u_int32				*realMsecP
+)
+{
+	G_alarm.active   = TRUE;
+	G_alarm.periodUs = msec * 1000;
+	G_alarm.nextUs   = G_timeUs + G_alarm.periodUs;
+	*realMsecP = msec;
+	return(0);
+}
+
+int32 OSS_AlarmClear(
+	OSS_HANDLE			*osHdl,
+	OSS_ALARM_HANDLE	*alarm
+)
+{
+	G_alarm.active = FALSE;
+	return(0);
+}
+
+int32 OSS_SigCreate(
+	OSS_HANDLE		*osHdl,
+	int32			signal,
+	OSS_SIG_HANDLE	**sigHandleP
+)
+{
+	*sigHandleP = (OSS_SIG_HANDLE*)&G_sig;
+	return(0);
+}
+
+int32 OSS_SigSend(
+	OSS_HANDLE		*osHdl,
+	OSS_SIG_HANDLE	*sigHandle
+)
+{
+	G_simSigs++;
+	return(0);
+}
+
+int32 OSS_SigRemove(
+	OSS_HANDLE		*osHdl,
+	OSS_SIG_HANDLE	**sigHandleP
+)
+{
+	*sigHandleP = NULL;
+	return(0);
+}
+
+int32 OSS_SemCreate(
+	OSS_HANDLE		*osHdl,
+	int32			semType,
+	int32			initVal,
+	OSS_SEM_HANDLE	**semP
+)
+{
+	u_int32 n;
+
+	for( n=0; n<SEM_MAX; n++ ){
+		if( !G_sem[n].used ){
+			G_sem[n].used = TRUE;
+			G_sem[n].cnt  = initVal;
+			*semP = (OSS_SEM_HANDLE*)&G_sem[n];
+			return(0);
+		}
+	}
+	return(ERR_OSS_MEM_ALLOC);
+}
+
+int32 OSS_SemRemove(
+	OSS_HANDLE		*osHdl,
+	OSS_SEM_HANDLE	**semHandleP
+)
+{
+	((SIM_SEM*)*semHandleP)->used = FALSE;
+	*semHandleP = NULL;
+	return(0);
+}
+
+int32 OSS_SemWait(
+	OSS_HANDLE		*osHdl,
+	OSS_SEM_HANDLE	*semHandle,
+	int32			msec
+)
+{
+	SIM_SEM *sem = (SIM_SEM*)semHandle;
+
+	/* single threaded: nobody else can signal */
+	if( sem->cnt <= 0 ){
+		if( msec > 0 )
+			G_timeUs += (u_int32)msec * 1000;
+		return(ERR_OSS_TIMEOUT);
+	}
+
+	sem->cnt--;
+	return(0);
+}
+
+int32 OSS_SemSignal(
+	OSS_HANDLE		*osHdl,
+	OSS_SEM_HANDLE	*semHandle
+)
+{
+	((SIM_SEM*)semHandle)->cnt++;
+	return(0);
+}
+
+int32 OSS_SpinLockCreate(
+	OSS_HANDLE			*osHdl,
+	OSS_SPINL_HANDLE	**spinlP
+)
+{
+	u_int32 n;
+
+	for( n=0; n<SPINL_MAX; n++ ){
+		if( !G_spinl[n] ){
+			G_spinl[n] = 1;
+			*spinlP = (OSS_SPINL_HANDLE*)&G_spinl[n];
+			return(0);
+		}
+	}
+	return(ERR_OSS_MEM_ALLOC);
+}
+
+int32 OSS_SpinLockRemove(
+	OSS_HANDLE			*osHdl,
+	OSS_SPINL_HANDLE	**spinlP
+)
+{
+	*(int32*)*spinlP = 0;
+	*spinlP = NULL;
+	return(0);
+}
+
+int32 OSS_SpinLockAcquire(
+	OSS_HANDLE			*osHdl,
+	OSS_SPINL_HANDLE	*spinl
+)
+{
+	return(0);
+}
+
+int32 OSS_SpinLockRelease(
+	OSS_HANDLE			*osHdl,
+	OSS_SPINL_HANDLE	*spinl
+)
+{
+	return(0);
+}
+
+u_int32 OSS_TickGet(
+	OSS_HANDLE	*osHdl
+)
+{
+	return( G_timeUs / 1000 );
+}
+
+u_int32 OSS_TickRateGet(
+	OSS_HANDLE	*osHdl
+)
+{
+	return(1000);
+}
+
+int32 OSS_Delay(
+	OSS_HANDLE	*osHdl,
+	int32		msec
+)
+{
+	G_timeUs += (u_int32)msec * 1000;
+	return(msec);
+}
+
+int32 OSS_GetSmbHdl(
+	OSS_HANDLE	*osHdl,
+	u_int32		busNbr,
+	void		**smbHdlP
+)
+{
+	G_smbH.Capability    = G_simBus.noI2c ? 0 : SMB_FUNC_I2C;
+	G_smbH.WriteByte     = SimWriteByte;
+	G_smbH.WriteByteData = SimWriteByteData;
+	G_smbH.ReadByteData  = SimReadByteData;
+	G_smbH.WriteWordData = SimWriteWordData;
+	G_smbH.ReadWordData  = SimReadWordData;
+	G_smbH.I2CXfer       = G_simBus.noI2c ? NULL : SimI2CXfer;
+
+	*smbHdlP = (void*)&G_smbH;
+	return(0);
+}
+
+/*--------------------------------------+
+|   DESC stand-ins                      |
++--------------------------------------*/
+char *DESC_Ident( void )
+{
+	return("F14BC_SIM DESC");
+}
+
+int32 DESC_Init(
+	DESC_SPEC	*descSpec,
+	OSS_HANDLE	*osHdl,
+	DESC_HANDLE	**descHandleP
+)
+{
+	*descHandleP = (DESC_HANDLE*)G_desc;
+	return(0);
+}
+
+int32 DESC_Exit(
+	DESC_HANDLE	**descHandleP
+)
+{
+	*descHandleP = NULL;
+	return(0);
+}
+
+int32 DESC_DbgLevelSet(
+	DESC_HANDLE	*descHandle,
+	u_int32		dbgLevel
+)
+{
+	return(0);
+}
+
+int32 DESC_GetUInt32(
+	DESC_HANDLE	*descHandle,
+	u_int32		defVal,
+	u_int32		*valueP,
+	char		*keyFmt,
+	...
+)
+{
+	char	key[SIM_KEY_LEN];
+	va_list	ap;
+	u_int32	n;
+
+	va_start( ap, keyFmt );
+	vsprintf( key, keyFmt, ap );
+	va_end( ap );
+
+	for( n=0; n<G_descNbr; n++ ){
+		if( !strcmp( G_desc[n].key, key ) ){
+			*valueP = G_desc[n].value;
+			return(0);
+		}
+	}
+
+	*valueP = defVal;
+	return(ERR_DESC_KEY_NOTFOUND);
+}
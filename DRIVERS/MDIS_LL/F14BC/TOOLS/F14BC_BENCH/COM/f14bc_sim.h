@@ -0,0 +1,95 @@
+/***********************  I n c l u d e  -  F i l e  ***********************/
+/*!
+ *        \file  f14bc_sim.h
+ *
+ *      \author  dieter.pfeuffer@men.de
+ *
+ *       \brief  Simulated F14BC on a simulated SMB2 controller and
+ *               host stand-ins for the OSS and DESC libraries
+ *
+ *    \switches  (none)
+ */
+ /*
+ *---------------------------------------------------------------------------
+ * Copyright 2019, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+/*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _F14BC_SIM_H
+#define _F14BC_SIM_H
+
+#ifdef __cplusplus
+      extern "C" {
+#endif
+
+/*-----------------------------------------+
+|  DEFINES                                 |
++-----------------------------------------*/
+#define SIM_DEV_MAX			9		/**< max. simulated F14BCs on the bus */
+#define SIM_DESC_MAX		64		/**< max. descriptor keys */
+#define SIM_KEY_LEN			32		/**< max. descriptor key length */
+
+/*-----------------------------------------+
+|  TYPEDEFS                                |
++-----------------------------------------*/
+/** simulated F14BC */
+typedef struct {
+	u_int16	smbAddr;		/**< SMB address (0=unused) */
+	u_int8	fw2;			/**< firmware rev. 2.0 or later */
+	u_int8	reg[256];		/**< register map (F14BCI_xxx) */
+	u_int8	wdOn;			/**< watchdog running */
+	u_int16	wdTime;			/**< watchdog time [100ms] */
+	u_int32	wdTrigs;		/**< received watchdog triggers */
+	u_int32	resets;			/**< received software resets */
+} SIM_DEV;
+
+/** simulated SMBus */
+typedef struct {
+	SIM_DEV	dev[SIM_DEV_MAX];	/**< simulated F14BCs */
+	u_int32	latUs;			/**< latency per transaction [us] */
+	u_int32	byteUs;			/**< additional latency per data byte [us] */
+	u_int32	faultEvery;		/**< fail every n-th transaction (0=off) */
+	int32	faultErr;		/**< SMB_ERR_xxx of injected faults */
+	u_int8	noI2c;			/**< controller without I2C support */
+	/* counters (cleared with SIM_CountClr) */
+	u_int32	xfers;			/**< SMBus transactions */
+	u_int32	faults;			/**< injected faults */
+	u_int32	busUs;			/**< bus time [us] */
+	u_int32	xferCmd[256];	/**< transactions per command */
+} SIM_BUS;
+
+/*-----------------------------------------+
+|  GLOBALS                                 |
++-----------------------------------------*/
+extern SIM_BUS G_simBus;		/* the simulated SMBus */
+extern u_int32 G_simSigs;		/* signals sent by the driver */
+
+/*-----------------------------------------+
+|  PROTOTYPES                              |
++-----------------------------------------*/
+extern SIM_DEV *SIM_DevAdd(u_int16 smbAddr, u_int32 fw2);
+extern void SIM_CountClr(void);
+extern u_int32 SIM_TimeUs(void);
+extern void SIM_TimeAdd(u_int32 us);
+extern void SIM_AlarmRun(u_int32 ms);
+extern void SIM_DescClr(void);
+extern void SIM_DescSet(char *key, u_int32 value);
+
+#ifdef __cplusplus
+      }
+#endif
+
+#endif /* _F14BC_SIM_H */
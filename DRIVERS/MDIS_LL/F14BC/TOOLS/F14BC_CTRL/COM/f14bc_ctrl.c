@@ -33,10 +33,12 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <MEN/men_typs.h>
 #include <MEN/usr_oss.h>
 #include <MEN/usr_utl.h>
 #include <MEN/mdis_api.h>
+#include <MEN/wdog.h>
 #include <MEN/f14bc_drv.h>
 #include <MEN/f14bci.h>
 
@@ -48,6 +50,22 @@ static const char IdentString[]=MENT_XSTR(MAK_REVISION);
 #define NONE			0
 #define	IO_MAX_NBR		8
 #define MAX_VOLT_CH		8
+#define SVEVT_NBR		16		/* max. events per M_getblock */
+#define SVEVT_TOUT		100		/* M_getblock timeout [ms] (key check) */
+
+/* getstats of one stream record (see StreamRun) */
+#define STREAM_SVSTATE	F14BCI_VOLT_NBR			/* index of supervision state */
+#define STREAM_ERRCNT	(F14BCI_VOLT_NBR + 1)	/* index of 1st error counter */
+#define STREAM_NBR		(STREAM_ERRCNT + F14BCI_ERRCNT_NBR)
+
+/* getstats of one export refresh (see ExportRun) */
+#define EXPORT_SVSTATE	0		/* supervision state */
+#define EXPORT_WARN		1		/* warning state */
+#define EXPORT_WDOG		2		/* watchdog state */
+#define EXPORT_NBR		3
+
+#define EXPORT_PERIOD	1000	/* default export refresh period [ms] */
+#define EXPORT_LABEL	128		/* max. length of escaped device label */
 
 /*--------------------------------------+
 |   GLOBALS                             |
@@ -64,7 +82,13 @@ static struct {
 +--------------------------------------*/
 static void usage(void);
 static void PrintMdisError(char *info);
-static void PrintUosError(char *info);
+static int32 StreamRun(u_int32 period, u_int32 count, u_int32 json);
+static int32 ExportRun(char *device, char *file, u_int32 period,
+					   u_int32 count);
+static int32 ExportWrite(char *device, char *file, int32 up, char *rev,
+						 F14BC_VOLT *volt, u_int8 *cnt, F14BC_MULTI *multi);
+static int32 LabelEscape(char *dst, const char *src, u_int32 size);
+static void PeriodWait(u_int32 *nextP, u_int32 period);
 
 /********************************* usage ***********************************/
 /**  Print program usage
@@ -81,6 +105,12 @@ static void usage(void)
 	printf("    -e           show error counters                       \n");
 	printf("    -c           clear error counters                      \n");
 	printf("    -f           show firmware revision                    \n");
+	printf("    -t=<ms>      stream voltages, supervision state and    \n");
+	printf("                 error counters every <ms> (CSV records)   \n");
+	printf("    -n=<nbr>     number of stream records       [0=endless]\n");
+	printf("    -j           stream JSON records instead of CSV        \n");
+	printf("    -x=<file>    export metrics to Prometheus textfile     \n");
+	printf("                 <file>, refreshed every -t=<ms>     [1000]\n");
 	printf("Note: Only option -r supports PIC firmware with rev. < 2.0\n");
 	printf("\n");
 	printf("Copyright 2006-2019, MEN Mikro Elektronik GmbH\n%s\n", IdentString);
@@ -96,15 +126,15 @@ static void usage(void)
  */
 int main( int argc, char *argv[])
 {
-	char	*device,*str,*errstr,buf[40];
-	int32	volt, superv, swr, err, clear, frev;
-	int32	n, val, ch;
-	int32	chNbr, in;
+	char	*device,*str,*errstr,buf[40],*export;
+	int32	volt, superv, swr, err, clear, frev, stream;
+	u_int32	count, json;
+	int32	n, ch;
 
 	/*--------------------+
     |  check arguments    |
     +--------------------*/
-	if( (errstr = UTL_ILLIOPT("vsr=ecf?", buf)) ){	/* check args */
+	if( (errstr = UTL_ILLIOPT("vsr=ecft=n=jx=?", buf)) ){	/* check args */
 		printf("*** %s\n", errstr);
 		return(1);
 	}
@@ -143,6 +173,10 @@ int main( int argc, char *argv[])
 	err = (UTL_TSTOPT("e") ? 1 : NONE);
 	clear = (UTL_TSTOPT("c") ? 1 : NONE);
 	frev = (UTL_TSTOPT("f") ? 1 : NONE);
+	stream = ((str = UTL_TSTOPT("t=")) ? atoi(str) : NONE);
+	count = ((str = UTL_TSTOPT("n=")) ? atoi(str) : 0);
+	json = (UTL_TSTOPT("j") ? 1 : 0);
+	export = UTL_TSTOPT("x=");
 
 	/*--------------------+
     |  open path          |
@@ -156,46 +190,26 @@ int main( int argc, char *argv[])
     |  show voltage values  |
     +----------------------*/
 	if( volt != NONE ){
+		M_SG_BLOCK	blk;
+		F14BC_VOLT	voltAll[F14BCI_VOLT_NBR];
+
 		printf("ch   in[mV]   nominal[mV]   deviation(range)[mV]\n");
 
-		if ((M_getstat(G_Path, M_LL_CH_NUMBER, &chNbr)) < 0) {
-			PrintMdisError("getstat M_LL_CH_NUMBER");
-			goto abort;
-		}
+		/* get all voltages at once */
+		blk.size = sizeof(voltAll);
+		blk.data = (void*)voltAll;
 
-		if( chNbr > MAX_VOLT_CH ){
-			printf("F14BC_CTRL supports only %d volt-ch (drv. reports %d)",
-				MAX_VOLT_CH, chNbr);
-			chNbr = MAX_VOLT_CH;
+		if ((M_getstat(G_Path, F14BC_BLK_VOLT_ALL, (int32*)&blk)) < 0) {
+			PrintMdisError("getstat F14BC_BLK_VOLT_ALL");
+			goto abort;
 		}
 
-		for( ch=0; ch<chNbr; ch++ ){
-
-			/* select channel */
-			if( (M_setstat(G_Path, M_MK_CH_CURRENT, ch)) < 0) {
-				PrintMdisError("setstat M_MK_CH_CURRENT");
-				goto abort;
-			}
-
-			/* get in voltage */
-			if ((M_getstat(G_Path, F14BC_VOLT_IN, &in)) < 0) {
-				PrintMdisError("getstat F14BC_VOLT_IN");
-				goto abort;
-			}
-
-			/* get nominal voltage */
-			if ((M_getstat(G_Path, F14BC_VOLT_NOM, &G_VoltCh[ch].nom)) < 0) {
-				PrintMdisError("getstat F14BC_VOLT_NOM");
-				goto abort;
-			}
+		for( ch=0; ch<F14BCI_VOLT_NBR; ch++ ){
 
-			/* get deviation voltage */
-			if ((M_getstat(G_Path, F14BC_VOLT_DEV, &G_VoltCh[ch].dev)) < 0) {
-				PrintMdisError("getstat F14BC_VOLT_DEV");
-				goto abort;
-			}
+			G_VoltCh[ch].nom = voltAll[ch].nom;
+			G_VoltCh[ch].dev = voltAll[ch].dev;
 
-			printf(" %d     %4d          ", ch, in);
+			printf(" %d     %4d          ", ch, voltAll[ch].in);
 
 			if( G_VoltCh[ch].nom )
 				printf("%4d      ", G_VoltCh[ch].nom);
@@ -216,57 +230,65 @@ int main( int argc, char *argv[])
     |  voltage supervision  |
     +----------------------*/
 	if( superv != NONE ){
-		u_int32 rcvSig;
-		int32	lastSvState;
+		F14BC_SVEVENT	evt[SVEVT_NBR];
+		int32			caps, nbr, n;
 
 		printf("Voltage supervision:\n");
-		printf("The driver polls the voltage supervision state and sends\n");
-		printf("a signal to the app. if a voltage over-/underrun occures.\n");
-		printf("Then, the app. gets the last polled voltage supervision state.\n");
-
-		/* init signal handling */
-		if( UOS_SigInit(NULL) ){
-			PrintUosError("SigInit");
-			return(1);
-		}
+		printf("The driver polls the voltage supervision state and records\n");
+		printf("an event if a voltage over-/underrun occures. The app. waits\n");
+		printf("in M_getblock() until events are recorded and gets them all.\n");
 
-		/* install signal */
-		if( UOS_SigInstall(UOS_SIG_USR1) ){
-			PrintUosError("SigInstall");
+		/* get supervised channels */
+		if ((M_getstat(G_Path, F14BC_CAPS, &caps)) < 0) {
+			PrintMdisError("getstat F14BC_CAPS");
 			goto abort;
 		}
 
-		UOS_SigMask();
+		/* get nominal voltages and deviations (unless -v got them) */
+		if( volt == NONE ){
+			M_SG_BLOCK	blk;
+			F14BC_VOLT	voltAll[F14BCI_VOLT_NBR];
+
+			blk.size = sizeof(voltAll);
+			blk.data = (void*)voltAll;
+
+			if ((M_getstat(G_Path, F14BC_BLK_VOLT_ALL, (int32*)&blk)) < 0) {
+				PrintMdisError("getstat F14BC_BLK_VOLT_ALL");
+				goto abort;
+			}
+
+			for( ch=0; ch<F14BCI_VOLT_NBR; ch++ ){
+				G_VoltCh[ch].nom = voltAll[ch].nom;
+				G_VoltCh[ch].dev = voltAll[ch].dev;
+			}
+		}
 
-		/* install signal for voltage supervision */
-		if( (M_setstat(G_Path, F14BC_VOLT_SIGSET, (int32)UOS_SIG_USR1) < 0)) {
-			PrintMdisError("setstat F14BC_VOLT_SIGSET");
+		/* let M_getblock() wait for events (enables polling) */
+		if( (M_setstat(G_Path, F14BC_SVEVT_TOUT, SVEVT_TOUT) < 0)) {
+			PrintMdisError("setstat F14BC_SVEVT_TOUT");
 			goto abort;
 		}
 
 		printf("--- press any key to abort ---\n");
 
 		do{
-			UOS_SigWait( 100, &rcvSig );
-
-			/* our signal? */
-			if( rcvSig == UOS_SIG_USR1 ){
-
-				/* get last supervision error state */
-				if ((M_getstat(G_Path, F14BC_VOLT_SVSTATE, &lastSvState)) < 0) {
-					PrintMdisError("getstat F14BC_VOLT_SVSTATE");
-					goto abort;
-				}
+			/* wait for events */
+			if( (nbr = M_getblock(G_Path, (u_int8*)evt, sizeof(evt))) < 0 ){
+				PrintMdisError("getblock");
+				break;
+			}
 
+			for( n=0; n < nbr / (int32)sizeof(F14BC_SVEVENT); n++ ){
 				for( ch=0; ch<MAX_VOLT_CH; ch++ ){
 
-					if( !G_VoltCh[ch].nom )
+					if( !(caps & F14BC_CAP_CH(ch)) )
 						continue;
 
 					/* voltage out of range? */
-					if( 0x01 & (lastSvState >> ch) ){
+					if( 0x01 & (evt[n].state >> ch) ){
 
-						printf(">>> volt-ch %d (nominal=%dmV) out of range (%dmV..%dmV)\n",
+						printf(">>> %s: volt-ch %d (nominal=%dmV) out of range (%dmV..%dmV)\n",
+							(evt[n].type == F14BC_SVEVT_WARN) ? "warning" : "error",
 							ch, G_VoltCh[ch].nom,
 							G_VoltCh[ch].nom - G_VoltCh[ch].dev,
 							G_VoltCh[ch].nom + G_VoltCh[ch].dev);
@@ -274,6 +296,8 @@ int main( int argc, char *argv[])
 				}
 			}
 		} while( (UOS_KeyPressed() == -1) );
+
+		M_setstat(G_Path, F14BC_SVEVT_TOUT, 0);
 	}
 
 	/*--------------------+
@@ -291,56 +315,26 @@ int main( int argc, char *argv[])
     |  show error counters  |
     +----------------------*/
 	if( err != NONE ){
-		printf("Error Counters:\n");
-
-		/* watchdog reset */
-		if ((M_getstat(G_Path, F14BC_ERRCNT_WDOG, &val)) < 0) {
-			PrintMdisError("getstat F14BC_ERRCNT_WDOG");
-			goto abort;
-		}
-		printf("- watchdog reset                : 0x%02x\n", (u_int8)val );
-
-		/* no BIOS start state 1 */
-		if ((M_getstat(G_Path, F14BC_ERRCNT_BIOS_1, &val)) < 0) {
-			PrintMdisError("getstat F14BC_ERRCNT_BIOS_1");
-			goto abort;
-		}
-		printf("- no BIOS start state 1         : 0x%02x\n", (u_int8)val );
-
-		/* no BIOS start state 2 */
-		if ((M_getstat(G_Path, F14BC_ERRCNT_BIOS_2, &val)) < 0) {
-			PrintMdisError("getstat F14BC_ERRCNT_BIOS_2");
-			goto abort;
-		}
-		printf("- no BIOS start state 2         : 0x%02x\n", (u_int8)val );
-
-		/* signal SLP_S5 not high */
-		if ((M_getstat(G_Path, F14BC_ERRCNT_SLP_S5, &val)) < 0) {
-			PrintMdisError("getstat F14BC_ERRCNT_SLP_S5");
-			goto abort;
-		}
-		printf("- signal SLP_S5 not high        : 0x%02x\n", (u_int8)val );
+		M_SG_BLOCK	blk;
+		u_int8		cnt[F14BCI_ERRCNT_NBR];
 
-		/* signal PLT_RST not deasserted */
-		if ((M_getstat(G_Path, F14BC_ERRCNT_RST, &val)) < 0) {
-			PrintMdisError("getstat F14BC_ERRCNT_RST");
-			goto abort;
-		}
-		printf("- signal PLT_RST not deasserted : 0x%02x\n", (u_int8)val );
+		printf("Error Counters:\n");
 
-		/* temperature emergency cutout */
-		if ((M_getstat(G_Path, F14BC_ERRCNT_TEMP, &val)) < 0) {
-			PrintMdisError("getstat F14BC_ERRCNT_TEMP");
-			goto abort;
-		}
-		printf("- temperature emergency cutout  : 0x%02x\n", (u_int8)val );
+		/* get all counters at once */
+		blk.size = sizeof(cnt);
+		blk.data = (void*)cnt;
 
-		/* processor hot */
-		if ((M_getstat(G_Path, F14BC_ERRCNT_PROCHOT, &val)) < 0) {
-			PrintMdisError("getstat F14BC_ERRCNT_PROCHOT");
+		if ((M_getstat(G_Path, F14BC_BLK_ERRCNT_ALL, (int32*)&blk)) < 0) {
+			PrintMdisError("getstat F14BC_BLK_ERRCNT_ALL");
 			goto abort;
 		}
-		printf("- processor hot                 : 0x%02x\n", (u_int8)val );
+		printf("- watchdog reset                : 0x%02x\n", cnt[0] );
+		printf("- no BIOS start state 1         : 0x%02x\n", cnt[1] );
+		printf("- no BIOS start state 2         : 0x%02x\n", cnt[2] );
+		printf("- signal SLP_S5 not high        : 0x%02x\n", cnt[3] );
+		printf("- signal PLT_RST not deasserted : 0x%02x\n", cnt[4] );
+		printf("- temperature emergency cutout  : 0x%02x\n", cnt[5] );
+		printf("- processor hot                 : 0x%02x\n", cnt[6] );
 	}
 
 	/*--------------------+
@@ -373,15 +367,28 @@ int main( int argc, char *argv[])
 			rev[0],rev[1],rev[2],rev[3],rev[4],rev[5]);
 	}
 
+	/*-------------------------------+
+    |  stream telemetry records      |
+    +-------------------------------*/
+	if( (stream != NONE) && !export ){
+		if( StreamRun( stream, count, json ) )
+			goto abort;
+	}
+
+	/*-------------------------------+
+    |  export metrics                |
+    +-------------------------------*/
+	if( export ){
+		if( ExportRun( device, export, stream ? stream : EXPORT_PERIOD,
+					   count ) )
+			goto abort;
+	}
+
 	/*--------------------+
     |  cleanup            |
     +--------------------*/
 	abort:
 
-	if( superv != NONE ){
-		UOS_SigExit();
-	}
-
 	if( M_close(G_Path) < 0 )
 		PrintMdisError("close");
 
@@ -398,13 +405,396 @@ static void PrintMdisError(char *info)
 	printf("*** can't %s: %s\n", info, M_errstring(UOS_ErrnoGet()));
 }
 
-/********************************* PrintUosError ***************************/
-/** Print User OSS error message
+/********************************* StreamRun *******************************/
+/** Stream telemetry records until a key is pressed or count records
+ *  were written
  *
- *  \param info       \IN  info string
-*/
-static void PrintUosError(char *info)
+ *  The path stays open, so the device probing of M_open is paid once.
+ *  Each record is read with one F14BC_BLK_MULTI getstat and written as
+ *  one line to stdout:
+ *  - CSV: time,in0..in6,svstate,errcnt0..errcnt6 (after a header line)
+ *  - JSON: {"time":..,"in":[..],"svstate":..,"errcnt":[..]}
+ *
+ *  time is the monotonic time since stream start [ms]. Values that
+ *  could not be read are empty (CSV) or null (JSON).
+ *
+ *  svstate is the current supervision state of the driver's poll
+ *  (#F14BC_VOLT_SVCUR), so #F14BC_VOLT_POLL is enabled while streaming
+ *  and restored afterwards.
+ *
+ *  \param period     \IN  record period [ms]
+ *  \param count      \IN  number of records (0=endless)
+ *  \param json       \IN  JSON records instead of CSV
+ *
+ *  \return	          success (0) or error (1)
+ */
+static int32 StreamRun(u_int32 period, u_int32 count, u_int32 json)
 {
-	printf("*** can't %s: %s\n", info, UOS_ErrString(UOS_ErrnoGet()));
+	M_SG_BLOCK	blk;
+	F14BC_MULTI	multi[STREAM_NBR];
+	u_int32		start, next, now, n;
+	int32		i, poll, ret = 0;
+
+	for( i=0; i<F14BCI_VOLT_NBR; i++ ){
+		multi[i].code = F14BC_VOLT_IN;
+		multi[i].ch = i;
+	}
+	multi[STREAM_SVSTATE].code = F14BC_VOLT_SVCUR;
+	multi[STREAM_SVSTATE].ch = 0;
+	for( i=0; i<F14BCI_ERRCNT_NBR; i++ ){
+		multi[STREAM_ERRCNT + i].code = F14BC_ERRCNT_WDOG + i;
+		multi[STREAM_ERRCNT + i].ch = 0;
+	}
+
+	if( !json ){
+		printf("time");
+		for( i=0; i<F14BCI_VOLT_NBR; i++ )
+			printf(",in%d", i);
+		printf(",svstate");
+		for( i=0; i<F14BCI_ERRCNT_NBR; i++ )
+			printf(",errcnt%d", i);
+		printf("\n");
+	}
+
+	/* supervision state requires the poll */
+	if ((M_getstat(G_Path, F14BC_VOLT_POLL, &poll)) < 0) {
+		PrintMdisError("getstat F14BC_VOLT_POLL");
+		return(1);
+	}
+	if ((M_setstat(G_Path, F14BC_VOLT_POLL, 1)) < 0) {
+		PrintMdisError("setstat F14BC_VOLT_POLL");
+		return(1);
+	}
+
+	start = next = UOS_MsecTimerGet();
+
+	for( n=0; !count || (n<count); n++ ){
+
+		blk.size = sizeof(multi);
+		blk.data = (void*)multi;
+
+		if ((M_getstat(G_Path, F14BC_BLK_MULTI, (int32*)&blk)) < 0) {
+			PrintMdisError("getstat F14BC_BLK_MULTI");
+			ret = 1;
+			break;
+		}
+
+		now = UOS_MsecTimerGet();
+
+		for( i=0; i<STREAM_NBR; i++ ){
+			/* record start and separator */
+			if( json ){
+				if( i == 0 )
+					printf("{\"time\":%u,\"in\":[", now - start);
+				else if( i == STREAM_SVSTATE )
+					printf("],\"svstate\":");
+				else if( i == STREAM_ERRCNT )
+					printf(",\"errcnt\":[");
+				else
+					printf(",");
+			}
+			else {
+				if( i == 0 )
+					printf("%u", now - start);
+				printf(",");
+			}
+
+			/* value */
+			if( !multi[i].err )
+				printf("%d", multi[i].value);
+			else if( json )
+				printf("null");
+		}
+		printf( json ? "]}\n" : "\n" );
+		fflush(stdout);
+
+		if( (count && (n+1 == count)) || (UOS_KeyPressed() != -1) )
+			break;
+
+		PeriodWait( &next, period );
+	}
+
+	if ((M_setstat(G_Path, F14BC_VOLT_POLL, poll)) < 0) {
+		PrintMdisError("setstat F14BC_VOLT_POLL");
+		ret = 1;
+	}
+
+	return(ret);
+}
+
+/********************************* ExportRun *******************************/
+/** Export metrics to a Prometheus textfile until a key is pressed or
+ *  count refreshes were done
+ *
+ *  The path stays open and the metrics are refreshed every period. The
+ *  file is written as <file>.tmp and renamed to <file>, so a scraper
+ *  (e.g. the textfile collector of the node exporter) reads the last
+ *  complete refresh without any bus access. If a refresh fails, only
+ *  f14bc_up 0 and the firmware revision are exported.
+ *
+ *  One refresh costs three getstats: #F14BC_BLK_VOLT_ALL,
+ *  #F14BC_BLK_ERRCNT_ALL and one #F14BC_BLK_MULTI for the supervision,
+ *  warning and watchdog state. The firmware revision is read once.
+ *
+ *  The supervision and warning state are maintained by the driver's
+ *  poll, so #F14BC_VOLT_POLL is enabled while exporting and restored
+ *  afterwards. The current (not latched) supervision state is exported.
+ *
+ *  \param device     \IN  device name (label of all metrics)
+ *  \param file       \IN  textfile
+ *  \param period     \IN  refresh period [ms]
+ *  \param count      \IN  number of refreshes (0=endless)
+ *
+ *  \return	          success (0) or error (1)
+ */
+static int32 ExportRun(char *device, char *file, u_int32 period,
+					   u_int32 count)
+{
+	M_SG_BLOCK	blk;
+	F14BC_VOLT	volt[F14BCI_VOLT_NBR];
+	u_int8		cnt[F14BCI_ERRCNT_NBR];
+	F14BC_MULTI	multi[EXPORT_NBR];
+	char		rev[7], label[EXPORT_LABEL];
+	u_int32		next, n;
+	int32		up, poll, ret = 0;
+
+	if( LabelEscape( label, device, sizeof(label) ) ){
+		printf("*** device name too long\n");
+		return(1);
+	}
+
+	multi[EXPORT_SVSTATE].code = F14BC_VOLT_SVCUR;
+	multi[EXPORT_WARN].code = F14BC_VOLT_WARNSTATE;
+	multi[EXPORT_WDOG].code = WDOG_STATUS;
+	for( n=0; n<EXPORT_NBR; n++ )
+		multi[n].ch = 0;
+
+	/* firmware revision does not change */
+	blk.size = sizeof(rev) - 1;
+	blk.data = (void*)rev;
+
+	if ((M_getstat(G_Path, F14BC_BLK_FWREV, (int32*)&blk)) < 0) {
+		PrintMdisError("getstat F14BC_BLK_FWREV");
+		return(1);
+	}
+	rev[6] = '\0';
+
+	/* supervision state requires the poll */
+	if ((M_getstat(G_Path, F14BC_VOLT_POLL, &poll)) < 0) {
+		PrintMdisError("getstat F14BC_VOLT_POLL");
+		return(1);
+	}
+	if ((M_setstat(G_Path, F14BC_VOLT_POLL, 1)) < 0) {
+		PrintMdisError("setstat F14BC_VOLT_POLL");
+		return(1);
+	}
+
+	next = UOS_MsecTimerGet();
+
+	for( n=0; !count || (n<count); n++ ){
+
+		up = 1;
+
+		blk.size = sizeof(volt);
+		blk.data = (void*)volt;
+		if ((M_getstat(G_Path, F14BC_BLK_VOLT_ALL, (int32*)&blk)) < 0) {
+			PrintMdisError("getstat F14BC_BLK_VOLT_ALL");
+			up = 0;
+		}
+
+		blk.size = sizeof(cnt);
+		blk.data = (void*)cnt;
+		if( up &&
+			(M_getstat(G_Path, F14BC_BLK_ERRCNT_ALL, (int32*)&blk)) < 0) {
+			PrintMdisError("getstat F14BC_BLK_ERRCNT_ALL");
+			up = 0;
+		}
+
+		blk.size = sizeof(multi);
+		blk.data = (void*)multi;
+		if( up &&
+			(M_getstat(G_Path, F14BC_BLK_MULTI, (int32*)&blk)) < 0) {
+			PrintMdisError("getstat F14BC_BLK_MULTI");
+			up = 0;
+		}
+
+		if( ExportWrite( label, file, up, rev, volt, cnt, multi ) ){
+			ret = 1;
+			break;
+		}
+
+		if( (count && (n+1 == count)) || (UOS_KeyPressed() != -1) )
+			break;
+
+		PeriodWait( &next, period );
+	}
+
+	if ((M_setstat(G_Path, F14BC_VOLT_POLL, poll)) < 0) {
+		PrintMdisError("setstat F14BC_VOLT_POLL");
+		ret = 1;
+	}
+
+	return(ret);
 }
 
+/******************************** ExportWrite ******************************/
+/** Write the metrics of one refresh to the textfile
+ *
+ *  \param device     \IN  device name (escaped label value)
+ *  \param file       \IN  textfile
+ *  \param up         \IN  refresh succeeded
+ *  \param rev        \IN  firmware revision
+ *  \param volt       \IN  voltages of all channels
+ *  \param cnt        \IN  all error counters
+ *  \param multi      \IN  supervision, warning and watchdog state
+ *
+ *  \return	          success (0) or error (1)
+ */
+static int32 ExportWrite(char *device, char *file, int32 up, char *rev,
+						 F14BC_VOLT *volt, u_int8 *cnt, F14BC_MULTI *multi)
+{
+	static const char *cntName[F14BCI_ERRCNT_NBR] = {
+		"watchdog_reset", "bios_start_1", "bios_start_2", "slp_s5",
+		"plt_rst", "temp_cutout", "prochot"
+	};
+	char	tmp[256];
+	FILE	*fp;
+	int32	ch, n;
+
+	if( strlen(file) + 5 > sizeof(tmp) ){
+		printf("*** export file name too long\n");
+		return(1);
+	}
+	sprintf( tmp, "%s.tmp", file );
+
+	if( (fp = fopen( tmp, "w" )) == NULL ){
+		printf("*** can't create %s\n", tmp);
+		return(1);
+	}
+
+	fprintf(fp, "# HELP f14bc_up 1 if the last refresh succeeded\n");
+	fprintf(fp, "# TYPE f14bc_up gauge\n");
+	fprintf(fp, "f14bc_up{device=\"%s\"} %d\n", device, up);
+
+	fprintf(fp, "# HELP f14bc_firmware_info PIC firmware revision\n");
+	fprintf(fp, "# TYPE f14bc_firmware_info gauge\n");
+	fprintf(fp, "f14bc_firmware_info{device=\"%s\",revision=\"%c%c.%c%c.%c%c\"} 1\n",
+			device, rev[0], rev[1], rev[2], rev[3], rev[4], rev[5]);
+
+	if( up ){
+		fprintf(fp, "# HELP f14bc_voltage_mv PIC input voltage [mV]\n");
+		fprintf(fp, "# TYPE f14bc_voltage_mv gauge\n");
+		for( ch=0; ch<F14BCI_VOLT_NBR; ch++ )
+			fprintf(fp, "f14bc_voltage_mv{device=\"%s\",ch=\"%d\"} %d\n",
+					device, ch, volt[ch].in);
+
+		fprintf(fp, "# HELP f14bc_voltage_nominal_mv nominal voltage [mV]\n");
+		fprintf(fp, "# TYPE f14bc_voltage_nominal_mv gauge\n");
+		for( ch=0; ch<F14BCI_VOLT_NBR; ch++ )
+			fprintf(fp, "f14bc_voltage_nominal_mv{device=\"%s\",ch=\"%d\"} %d\n",
+					device, ch, volt[ch].nom);
+
+		fprintf(fp, "# HELP f14bc_voltage_deviation_mv deviation voltage [mV]\n");
+		fprintf(fp, "# TYPE f14bc_voltage_deviation_mv gauge\n");
+		for( ch=0; ch<F14BCI_VOLT_NBR; ch++ )
+			fprintf(fp, "f14bc_voltage_deviation_mv{device=\"%s\",ch=\"%d\"} %d\n",
+					device, ch, volt[ch].dev);
+
+		if( !multi[EXPORT_SVSTATE].err ){
+			fprintf(fp, "# HELP f14bc_supervision_error current supervision error state\n");
+			fprintf(fp, "# TYPE f14bc_supervision_error gauge\n");
+			for( ch=0; ch<F14BCI_VOLT_NBR; ch++ )
+				fprintf(fp, "f14bc_supervision_error{device=\"%s\",ch=\"%d\"} %d\n",
+						device, ch, (multi[EXPORT_SVSTATE].value >> ch) & 0x1);
+		}
+
+		if( !multi[EXPORT_WARN].err ){
+			fprintf(fp, "# HELP f14bc_supervision_warning software warning state\n");
+			fprintf(fp, "# TYPE f14bc_supervision_warning gauge\n");
+			for( ch=0; ch<F14BCI_VOLT_NBR; ch++ )
+				fprintf(fp, "f14bc_supervision_warning{device=\"%s\",ch=\"%d\"} %d\n",
+						device, ch, (multi[EXPORT_WARN].value >> ch) & 0x1);
+		}
+
+		fprintf(fp, "# HELP f14bc_error_count 8-bit error counter of the PIC\n");
+		fprintf(fp, "# TYPE f14bc_error_count gauge\n");
+		for( n=0; n<F14BCI_ERRCNT_NBR; n++ )
+			fprintf(fp, "f14bc_error_count{device=\"%s\",counter=\"%s\"} %d\n",
+					device, cntName[n], cnt[n]);
+
+		if( !multi[EXPORT_WDOG].err ){
+			fprintf(fp, "# HELP f14bc_watchdog_running 1 if the watchdog is running\n");
+			fprintf(fp, "# TYPE f14bc_watchdog_running gauge\n");
+			fprintf(fp, "f14bc_watchdog_running{device=\"%s\"} %d\n",
+					device, multi[EXPORT_WDOG].value ? 1 : 0);
+		}
+	}
+
+	if( fclose( fp ) ){
+		printf("*** can't write %s\n", tmp);
+		return(1);
+	}
+
+	/* replace the file atomically */
+	if( rename( tmp, file ) ){
+		printf("*** can't rename %s to %s\n", tmp, file);
+		remove( tmp );
+		return(1);
+	}
+
+	return(0);
+}
+
+/******************************** LabelEscape ******************************/
+/** Escape a label value for the Prometheus text format
+ *
+ *  Backslash, double-quote and line feed are written as \\, \" and \n.
+ *
+ *  \param dst        \OUT escaped value
+ *  \param src        \IN  value
+ *  \param size       \IN  size of dst
+ *
+ *  \return	          success (0) or error (1) if dst is too small
+ */
+static int32 LabelEscape(char *dst, const char *src, u_int32 size)
+{
+	u_int32 n = 0;
+
+	for( ; *src; src++ ){
+		if( n + 3 > size )
+			return(1);
+
+		switch( *src ){
+			case '\\':	dst[n++] = '\\'; dst[n++] = '\\'; break;
+			case '"':	dst[n++] = '\\'; dst[n++] = '"';  break;
+			case '\n':	dst[n++] = '\\'; dst[n++] = 'n';  break;
+			default:	dst[n++] = *src;
+		}
+	}
+	dst[n] = '\0';
+
+	return(0);
+}
+
+/******************************** PeriodWait *******************************/
+/** Wait for the next deadline of a fixed-rate loop
+ *
+ *  The next deadline is relative to the previous one, so the period
+ *  does not drift. If the deadline has already passed, the loop
+ *  continues without delay.
+ *
+ *  \param nextP      \INOUT  previous/next deadline [ms]
+ *  \param period     \IN     period [ms]
+ */
+static void PeriodWait(u_int32 *nextP, u_int32 period)
+{
+	u_int32 now;
+
+	*nextP += period;
+	now = UOS_MsecTimerGet();
+
+	if( (int32)(*nextP - now) > 0 )
+		UOS_Delay( *nextP - now );
+	else
+		*nextP = now;
+}
@@ -35,6 +35,7 @@ MAK_INCL=$(MEN_INC_DIR)/f14bc_drv.h	\
          $(MEN_INC_DIR)/f14bci.h		\
          $(MEN_INC_DIR)/men_typs.h	\
          $(MEN_INC_DIR)/mdis_api.h	\
+         $(MEN_INC_DIR)/wdog.h		\
          $(MEN_INC_DIR)/usr_oss.h	\
          $(MEN_INC_DIR)/usr_utl.h
 
@@ -0,0 +1,382 @@
+/****************************************************************************
+ ************                                                    ************
+ ************                 F14BC_CTRL_BENCH                   ************
+ ************                                                    ************
+ ****************************************************************************/
+/*!
+ *         \file f14bc_ctrl_bench.c
+ *       \author dieter.pfeuffer@men.de
+ *
+ *        \brief Transaction count regression benchmark for f14bc_ctrl
+ *
+ *  Runs each f14bc_ctrl mode against the F14BC driver and a simulated,
+ *  counting F14BC (see f14bc_sim.c). The f14bc_ctrl tool, the driver and
+ *  the simulation are compiled into this program, the MDIS API calls of
+ *  the tool are served by the stand-ins below.
+ *
+ *  For each mode, the benchmark reports the SMBus transactions, MDIS API
+ *  calls and host time of one tool run and compares the counts with the
+ *  budgets in G_mode[]. The program fails (exit code 1) if a count
+ *  exceeds its budget or an MDIS call fails. If a driver improvement
+ *  lowers a count, the budget should be lowered as well.
+ *
+ *  Each tool run opens the device. The runs are measured with a warm
+ *  firmware revision cache, i.e. as on a system where the device was
+ *  opened before, so the counts include the watchdog state read of
+ *  F14BC_Init().
+ *
+ *     Required: libraries: usr_oss, usr_utl
+ *     \switches (none)
+ */
+ /*
+ *---------------------------------------------------------------------------
+ * Copyright 2019, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+/*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+
+/* the driver and the simulated F14BC */
+#include "../../../DRIVER/COM/f14bc_drv.c"
+#include "../../F14BC_BENCH/COM/f14bc_sim.c"
+
+/* the tool under test (output is discarded unless verbose) */
+static int CtrlPrintf(const char *fmt, ...);
+#define main			F14BC_CTRL_Main
+#define usage			CtrlUsage
+#define IdentString		CtrlIdentString
+#define printf			CtrlPrintf
+#include "../../F14BC_CTRL/COM/f14bc_ctrl.c"
+#undef main
+#undef usage
+#undef IdentString
+#undef printf
+
+static const char BenchIdentString[]=MENT_XSTR(MAK_REVISION);
+
+/*--------------------------------------+
+|   DEFINES                             |
++--------------------------------------*/
+#define SMB_ADDR		0x9a	/**< SMB address of simulated F14BC */
+#define MODE_ARGS		4		/**< max. tool arguments per mode */
+#define BENCH_PATH		1		/**< MDIS path of the stand-in */
+
+/*--------------------------------------+
+|   TYPEDEFS                            |
++--------------------------------------*/
+/** tool mode and its budgets */
+typedef struct {
+	char	*args[MODE_ARGS];	/**< tool options (NULL terminated) */
+	u_int32	blkRead;			/**< BLOCK_READ descriptor key */
+	u_int32	maxXfers;			/**< SMBus transaction budget per run */
+	u_int32	maxCalls;			/**< MDIS call budget per run */
+} BENCH_MODE;
+
+/*--------------------------------------+
+|   GLOBALS                             |
++--------------------------------------*/
+static const BENCH_MODE G_mode[] = {
+	/* args                      BLOCK_READ  xfers  calls */
+	{ { "-v", NULL },                    0,     22,     3 },
+	{ { "-e", NULL },                    0,      8,     3 },
+	{ { "-f", NULL },                    0,      1,     3 },
+	{ { "-c", NULL },                    0,      2,     3 },
+	{ { "-v", "-e", "-f", NULL },        0,     29,     5 },
+	{ { "-t=1", "-n=1", NULL },          0,     15,     6 },
+	{ { "-v", NULL },                    1,      4,     3 },
+	{ { "-e", NULL },                    1,      2,     3 },
+	{ { "-v", "-e", "-f", NULL },        1,      5,     5 },
+	{ { "-t=1", "-n=1", NULL },          1,     15,     6 },
+	{ { NULL },                          0,      0,     0 }
+};
+
+static LL_ENTRY		G_entry;
+static LL_HANDLE	*G_llHdl;		/* handle of the open path */
+static int32		G_ch;			/* current channel */
+static u_int32		G_calls;		/* MDIS calls */
+static u_int32		G_callErrs;		/* failed MDIS calls */
+static u_int32		G_verbose;		/* show tool output */
+
+/*--------------------------------------+
+|   PROTOTYPES                          |
++--------------------------------------*/
+static void BenchUsage(void);
+static int32 ModeRun(const BENCH_MODE *mode);
+static int32 CallDone(int32 error);
+
+/******************************* BenchUsage ********************************/
+/**  Print program usage
+ */
+static void BenchUsage(void)
+{
+	printf("Usage: f14bc_ctrl_bench [<opts>]\n");
+	printf("Function: Count SMBus transactions and MDIS calls of f14bc_ctrl\n");
+	printf("Options:\n");
+	printf("    -n=<nbr>     tool runs per mode (host time)      [1000]\n");
+	printf("    -v           show tool output                         \n");
+	printf("\n");
+	printf("Copyright 2019, MEN Mikro Elektronik GmbH\n%s\n",
+		   BenchIdentString);
+}
+
+/********************************* main ************************************/
+/** Program main function
+ *
+ *  \param argc       \IN  argument counter
+ *  \param argv       \IN  argument vector
+ *
+ *  \return	          success (0) or budget exceeded/error (1)
+ */
+int main( int argc, char *argv[])
+{
+	const BENCH_MODE	*mode;
+	char				*str, *errstr, buf[40], opts[20];
+	u_int32				nbr, n, xfers, calls, ms, fail = 0;
+	int32				i;
+
+	if( (errstr = UTL_ILLIOPT("n=v?", buf)) ){	/* check args */
+		printf("*** %s\n", errstr);
+		return(1);
+	}
+
+	if( UTL_TSTOPT("?") ){						/* help requested ? */
+		BenchUsage();
+		return(1);
+	}
+
+	nbr = ((str = UTL_TSTOPT("n=")) ? atoi(str) : 1000);
+	G_verbose = (UTL_TSTOPT("v") ? 1 : 0);
+	if( !nbr )
+		nbr = 1;
+
+	__F14BC_GetEntry( &G_entry );
+
+	if( SIM_DevAdd( SMB_ADDR, 1 ) == NULL )
+		return(1);
+
+	printf("%-14s %5s %7s %7s %7s %7s %10s %s\n", "mode", "blkrd",
+		   "xfers", "budget", "calls", "budget", "host[us]", "result");
+
+	for( mode=G_mode; mode->args[0]; mode++ ){
+		SIM_DescClr();
+		SIM_DescSet( "SMB_BUSNBR", 0 );
+		SIM_DescSet( "SMB_DEVADDR", SMB_ADDR );
+		SIM_DescSet( "BLOCK_READ", mode->blkRead );
+
+		/* warm up (firmware revision cache) */
+		if( ModeRun( mode ) )
+			fail = 1;
+
+		/* count one run */
+		SIM_CountClr();
+		G_calls = G_callErrs = 0;
+		ModeRun( mode );
+		xfers = G_simBus.xfers;
+		calls = G_calls;
+
+		/* host time */
+		ms = UOS_MsecTimerGet();
+		for( n=0; n<nbr; n++ )
+			ModeRun( mode );
+		ms = UOS_MsecTimerGet() - ms;
+
+		for( opts[0]='\0', i=0; (i<MODE_ARGS) && mode->args[i]; i++ ){
+			strcat( opts, mode->args[i] );
+			strcat( opts, " " );
+		}
+
+		printf("%-14s %5d %7d %7d %7d %7d %10d ", opts, mode->blkRead,
+			   xfers, mode->maxXfers, calls, mode->maxCalls,
+			   (int)((ms * 1000) / nbr));
+
+		if( G_callErrs ){
+			printf("FAILED (%d MDIS errors)\n", G_callErrs);
+			fail = 1;
+		}
+		else if( (xfers > mode->maxXfers) || (calls > mode->maxCalls) ){
+			printf("REGRESSION\n");
+			fail = 1;
+		}
+		else
+			printf("ok\n");
+	}
+
+	return(fail);
+}
+
+/********************************* ModeRun *********************************/
+/** Run the tool once in the given mode
+ *
+ *  \param mode       \IN  tool mode
+ *
+ *  \return	          0 or 1 if an MDIS call failed
+ */
+static int32 ModeRun(
+	const BENCH_MODE *mode
+)
+{
+	char	*argv[MODE_ARGS + 2];
+	int		argc = 0, i;
+	u_int32	errs = G_callErrs;
+
+	argv[argc++] = "f14bc_ctrl";
+	argv[argc++] = "f14bc_1";
+	for( i=0; (i<MODE_ARGS) && mode->args[i]; i++ )
+		argv[argc++] = mode->args[i];
+	argv[argc] = NULL;
+
+	F14BC_CTRL_Main( argc, argv );
+
+	return( G_callErrs != errs );
+}
+
+/******************************** CtrlPrintf *******************************/
+/** printf() of the tool
+ *
+ *  \param fmt        \IN  format string
+ *
+ *  \return	          number of printed characters
+ */
+static int CtrlPrintf(
+	const char	*fmt,
+	...
+)
+{
+	va_list	ap;
+	int		n = 0;
+
+	if( G_verbose ){
+		va_start( ap, fmt );
+		n = vprintf( fmt, ap );
+		va_end( ap );
+	}
+
+	return(n);
+}
+
+/******************************** CallDone *********************************/
+/** Count an MDIS call
+ *
+ *  \param error      \IN  error code of the driver
+ *
+ *  \return	          0 or -1 (error code in errno)
+ */
+static int32 CallDone(
+	int32	error
+)
+{
+	G_calls++;
+
+	if( error ){
+		G_callErrs++;
+		UOS_ErrnoSet( error );
+		return(-1);
+	}
+
+	return(0);
+}
+
+/*--------------------------------------+
+|   MDIS API stand-ins                  |
++--------------------------------------*/
+MDIS_PATH M_open(
+	const char	*device
+)
+{
+	if( G_llHdl )
+		return( CallDone( ERR_OSS_BUSY ) );
+
+	if( CallDone( G_entry.init( NULL, NULL, NULL, NULL, NULL, &G_llHdl ) ) )
+		return(-1);
+
+	G_ch = 0;
+	return(BENCH_PATH);
+}
+
+int32 M_close(
+	MDIS_PATH	path
+)
+{
+	if( !G_llHdl )
+		return( CallDone( ERR_LL_ILL_PARAM ) );
+
+	return( CallDone( G_entry.exit( &G_llHdl ) ) );
+}
+
+int32 M_getstat(
+	MDIS_PATH	path,
+	int32		code,
+	int32		*dataP
+)
+{
+	INT32_OR_64	value;
+	int32		error;
+
+	if( CODE_IS_BLK(code) )
+		return( CallDone( G_entry.getStat( G_llHdl, code, G_ch,
+										   (INT32_OR_64*)dataP ) ) );
+
+	if( code == M_MK_CH_CURRENT ){
+		*dataP = G_ch;
+		return( CallDone( ERR_SUCCESS ) );
+	}
+
+	error = G_entry.getStat( G_llHdl, code, G_ch, &value );
+	*dataP = (int32)value;
+	return( CallDone( error ) );
+}
+
+int32 M_setstat(
+	MDIS_PATH	path,
+	int32		code,
+	INT32_OR_64	data
+)
+{
+	if( code == M_MK_CH_CURRENT ){
+		if( (data < 0) || (data >= CH_NUMBER) )
+			return( CallDone( ERR_LL_ILL_CHAN ) );
+		G_ch = (int32)data;
+		return( CallDone( ERR_SUCCESS ) );
+	}
+
+	return( CallDone( G_entry.setStat( G_llHdl, code, G_ch, data ) ) );
+}
+
+int32 M_getblock(
+	MDIS_PATH	path,
+	u_int8		*buffer,
+	int32		length
+)
+{
+	int32 nbr = 0;
+
+	if( CallDone( G_entry.blockRead( G_llHdl, G_ch, buffer, length, &nbr ) ) )
+		return(-1);
+
+	return(nbr);
+}
+
+char *M_errstring(
+	int32	errCode
+)
+{
+	static char str[40];
+
+	sprintf( str, "error 0x%04x", errCode );
+	return(str);
+}
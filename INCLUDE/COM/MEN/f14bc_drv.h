@@ -37,13 +37,133 @@
       extern "C" {
 #endif
 
+/* array sizes of F14BC_XFER_STAT */
+#define F14BC_XFER_CMD_NBR	256		/**< number of SMB command codes */
+#define F14BC_XFER_ERR_NBR	16		/**< number of error counters */
+#define F14BC_XFER_LAT_NBR	16		/**< number of latency histogram bins */
+
+/* array sizes of F14BC_CTRL_SNAP */
+#define F14BC_CTRL_MAX		8		/**< max. number of additional controllers
+										 (CTRL_NUMBER descriptor key) */
+#define F14BC_CTRL_VOLT_NBR	7		/**< number of voltages (F14BCI_VOLT_NBR) */
+#define F14BC_CTRL_ERRCNT_NBR 7		/**< number of error counters
+										 (F14BCI_ERRCNT_NBR) */
+
 /*-----------------------------------------+
 |  TYPEDEFS                                |
 +-----------------------------------------*/
+/** voltage values of one channel (see #F14BC_BLK_VOLT_ALL) */
+typedef struct {
+	int32	in;		/**< PIC input voltage [mV] */
+	int32	nom;	/**< nominal voltage [mV] (0 if not supported) */
+	int32	dev;	/**< deviation voltage [mV] (0 if not supported) */
+} F14BC_VOLT;
+
+/** input voltage statistics of one channel (see #F14BC_BLK_VOLT_HIST) */
+typedef struct {
+	int32	min;		/**< min. input voltage [mV] */
+	int32	max;		/**< max. input voltage [mV] */
+	int32	avg;		/**< mean input voltage [mV] */
+	u_int32	samples;	/**< number of samples */
+} F14BC_VOLT_STAT;
+
+/** voltage supervision event (see #F14BC_BLK_SVEVENTS) */
+typedef struct {
+	u_int32	time;	/**< time since driver init [ms] */
+	u_int32	type;	/**< event type (F14BC_SVEVT_xxx) */
+	u_int32	state;	/**< new state, bit 6..0 corresponds to voltage 6..0 */
+} F14BC_SVEVENT;
+
+/** SMBus queue statistics of one access class (see #F14BC_BLK_BUSQ_STAT) */
+typedef struct {
+	u_int32	xfers;		/**< number of SMBus transactions */
+	u_int32	waits;		/**< transactions that found the SMBus busy */
+	u_int32	depth;		/**< number of waiting callers */
+	u_int32	depthMax;	/**< max. number of waiting callers */
+	u_int32	waitMax;	/**< max. wait time [ms] */
+	u_int32	waitSum;	/**< sum of all wait times [ms] */
+} F14BC_BUSQ_STAT;
+
+/** SMBus transaction statistics (see #F14BC_BLK_XFER_STAT) */
+typedef struct {
+	u_int32	cmd[F14BC_XFER_CMD_NBR];	/**< transactions per SMB command
+											 (F14BCI_xxx) */
+	u_int32	err[F14BC_XFER_ERR_NBR];	/**< errors per SMB2 error code
+											 (index 1..15), other errors
+											 (index 0) */
+	u_int32	lat[F14BC_XFER_LAT_NBR];	/**< latency histogram, index n:
+											 2^(n-1)..2^n-1 OSS ticks,
+											 index 0: <1 tick (see tickRate) */
+	u_int32	time;						/**< sum of transaction times [ms]
+											 (OSS tick resolution) */
+	u_int32	retries;					/**< number of retried transactions */
+	u_int32	trips;						/**< number of circuit breaker trips */
+	u_int32	tickRate;					/**< OSS tick rate [ticks/s], one
+											 tick is the time resolution */
+} F14BC_XFER_STAT;
+
+/** supervision state of one controller (see #F14BC_BLK_CTRL_SNAP) */
+typedef struct {
+	u_int32	busNbr;		/**< SMB bus number */
+	u_int32	smbAddr;	/**< SMB address */
+	int32	error;		/**< error code of the last sweep (0=success) */
+	u_int32	time;		/**< time of the last successful sweep
+							 since driver init [ms] */
+	u_int32	svState;	/**< supervision state, bit 6..0 corresponds
+							 to voltage 6..0 */
+	int32	in[F14BC_CTRL_VOLT_NBR];	/**< input voltages [mV] */
+	u_int8	errCnt[F14BC_CTRL_ERRCNT_NBR];	/**< 8-bit error counters in
+											 F14BCI_ERRCNT_NO_TRIG..
+											 F14BCI_ERRCNT_PROCHOT order */
+} F14BC_CTRL_SNAP;
+
+/** one request of a batch getstat (see #F14BC_BLK_MULTI) */
+typedef struct {
+	int32	code;	/**< getstat code (no block code) */
+	int32	ch;		/**< channel */
+	int32	value;	/**< returned value (valid if err=0) */
+	int32	err;	/**< returned error code (0=success) */
+} F14BC_MULTI;
 
 /*-----------------------------------------+
 |  DEFINES                                 |
 +-----------------------------------------*/
+/** \name F14BC SMBus access classes (index of F14BC_BUSQ_STAT array)
+ *  \anchor busq_classes
+ */
+/**@{*/
+#define F14BC_BUSQ_WDOG		0	/**< watchdog operations (highest priority) */
+#define F14BC_BUSQ_CALL		1	/**< other Getstat/Setstat calls */
+#define F14BC_BUSQ_ALARM	2	/**< driver's alarm (never waits, waits counts
+									 the skipped transactions) */
+#define F14BC_BUSQ_NBR		3	/**< number of access classes */
+/**@}*/
+
+/** \name F14BC capabilities (see #F14BC_CAPS)
+ *  \anchor caps
+ */
+/**@{*/
+#define F14BC_CAP_FW2		0x0001	/**< PIC firmware rev. 2.0 or later
+										 (all functionality) */
+#define F14BC_CAP_BLKRD		0x0004	/**< registers read with I2C block reads */
+#define F14BC_CAP_CH(c)		(0x0100 << (c))	/**< voltage channel c is
+												 supervised (nominal != 0) */
+/**@}*/
+
+/** \name F14BC specific error codes */
+/**@{*/
+#define F14BC_ERR_NORESP	(ERR_DEV+0x80)	/**< PIC not responding
+											 (circuit breaker open) */
+/**@}*/
+
+/** \name F14BC supervision event types
+ *  \anchor svevt_types
+ */
+/**@{*/
+#define F14BC_SVEVT_SUPERV	0x01	/**< firmware supervision state changed */
+#define F14BC_SVEVT_WARN	0x02	/**< software warning state changed */
+/**@}*/
+
 /** \name F14BC specific Getstat/Setstat codes
  *  \anchor getstat_setstat_codes
  *  (*) possible with FW-Rev 1.x
@@ -55,11 +175,11 @@
 #define F14BC_VOLT_IN		M_DEV_OF+0x01   /**< G: get PIC input voltage of current channel\n
 											      Values: [mV]\n
 												  Default: -\n*/
-#define F14BC_VOLT_NOM		M_DEV_OF+0x02   /**< G: get nominal voltage of current channel\n
-											      Values: [mV]\n
+#define F14BC_VOLT_NOM		M_DEV_OF+0x02   /**< G,S: get/set nominal voltage of current channel\n
+											      Values: [mV], multiple of 25mV, 0..6375\n
 												  Default: -\n*/
-#define F14BC_VOLT_DEV		M_DEV_OF+0x03   /**< G: get deviation voltage of current channel\n
-											      Values: [mV]\n
+#define F14BC_VOLT_DEV		M_DEV_OF+0x03   /**< G,S: get/set deviation voltage of current channel\n
+											      Values: [mV], multiple of 25mV, 0..6375\n
 												  Default: -\n*/
 #define F14BC_VOLT_SIGSET	M_DEV_OF+0x04   /**< S: install an user signal for voltage supervision\n
 											      Values: signal number (see usr_os.h)\n
@@ -95,12 +215,116 @@
 #define F14BC_ERRCNT_CLR	M_DEV_OF+0x0e   /**< S: clear all error counters\n
 											      Values: -\n
 												  Default: -\n*/
+#define F14BC_SNAP_AGE		M_DEV_OF+0x0f   /**< G: age of the register snapshot
+												  (only in snapshot mode)\n
+											      Values: [ms]\n
+												  Default: -\n*/
+#define F14BC_VOLT_POLL		M_DEV_OF+0x10   /**< G,S: poll the voltage supervision state
+												  without signal (records events)\n
+											      Values: 0=off, 1=on\n
+												  Default: 0\n*/
+#define F14BC_SVEVT_LOST	M_DEV_OF+0x11   /**< G: number of supervision events lost
+												  due to a full event ring\n
+											      Values: 0..0xffffffff\n
+												  Default: 0\n*/
+#define F14BC_POLL_PERIOD	M_DEV_OF+0x12   /**< G: current (adaptive) poll period for
+												  voltage supervision\n
+											      Values: POLL_PERIOD_MIN..POLL_PERIOD_MAX [ms]\n
+												  Default: POLL_PERIOD\n*/
+#define F14BC_VOLT_WARN_LO	M_DEV_OF+0x13   /**< G,S: low warning threshold of current channel\n
+											      Values: 0..6375 [mV], 0=disabled\n
+												  Default: 0\n*/
+#define F14BC_VOLT_WARN_HI	M_DEV_OF+0x14   /**< G,S: high warning threshold of current channel\n
+											      Values: 0..6375 [mV], 0=disabled\n
+												  Default: 0\n*/
+#define F14BC_VOLT_WARNSTATE M_DEV_OF+0x15  /**< G: software warning state, queried from the
+												  driver's poll-loop\n
+											      Values: bit 6..0 corresponds to voltage 6..0\n
+												  Default: 0\n*/
+#define F14BC_VOLT_HIST_CLR	M_DEV_OF+0x16   /**< S: restart the voltage history window\n
+											      Values: -\n
+												  Default: -\n*/
+#define F14BC_WDOG_TRIGSKIP	M_DEV_OF+0x17   /**< G: number of WDOG_TRIG calls acknowledged
+												  without SMBus access (coalescing) (*)\n
+											      Values: 0..0xffffffff\n
+												  Default: 0\n*/
+#define F14BC_WDOG_AUTO		M_DEV_OF+0x18   /**< G,S: driver triggers the watchdog as long
+												  as all liveness tokens are refreshed (*)\n
+											      Values: 0=off, 1=on\n
+												  Default: 0\n*/
+#define F14BC_WDOG_TOKEN	M_DEV_OF+0x19   /**< S: register/unregister a liveness token (*)\n
+											      Values: bit 31..24: token id 0..7\n
+												  bit 23..0: deadline [ms], 0=unregister\n
+												  Default: -\n*/
+#define F14BC_WDOG_ALIVE	M_DEV_OF+0x1a   /**< S: refresh a liveness token (no SMBus access) (*)\n
+											      Values: token id 0..7\n
+												  Default: -\n*/
+#define F14BC_BUSQ_CLR		M_DEV_OF+0x1b   /**< S: clear the SMBus queue statistics (*)\n
+											      Values: -\n
+												  Default: -\n*/
+#define F14BC_XFER_STAT_CLR	M_DEV_OF+0x1c   /**< S: clear the SMBus transaction statistics (*)\n
+											      Values: -\n
+												  Default: -\n*/
+#define F14BC_BREAKER		M_DEV_OF+0x1d   /**< G: circuit breaker state, S: close the
+												  circuit breaker (*)\n
+											      Values: G: 0=closed, 1=open, S: 0\n
+												  Default: 0\n*/
+#define F14BC_POLL_FAIL		M_DEV_OF+0x1e   /**< G: number of failed supervision polls\n
+											      Values: 0..0xffffffff\n
+												  Default: 0\n*/
+#define F14BC_CAPS			M_DEV_OF+0x1f   /**< G: driver/firmware capabilities (*)\n
+											      Values: see \ref caps "F14BC_CAP_xxx"\n
+												  Default: -\n*/
+#define F14BC_SVEVT_TOUT	M_DEV_OF+0x20   /**< G,S: timeout of F14BC_BlockRead waiting for
+												  supervision events (enables polling)\n
+											      Values: 0=no wait, 1..0x7fffffff [ms],
+												  -1=endless\n
+												  Default: 0\n*/
+#define F14BC_VOLT_SVCUR	M_DEV_OF+0x21   /**< G: current (debounced) supervision state of
+												  the driver's poll-loop, not latched\n
+											      Values: bit 6..0 corresponds to voltage 6..0\n
+												  Default: 0\n*/
 
 
 /* F14BC specific Getstat/Setstat block codes */
 #define F14BC_BLK_FWREV		M_DEV_BLK_OF+0x00    /**< S: firmware revision\n
 											      Values: six ascii characters\n
 												  Default: -\n*/
+#define F14BC_BLK_VOLT_ALL	M_DEV_BLK_OF+0x01    /**< G: voltage values of all channels\n
+											      Values: F14BC_VOLT[F14BCI_VOLT_NBR]\n
+												  Default: -\n*/
+#define F14BC_BLK_ERRCNT_ALL M_DEV_BLK_OF+0x02   /**< G: all 8-bit error counters\n
+											      Values: u_int8[F14BCI_ERRCNT_NBR] in
+												  F14BCI_ERRCNT_NO_TRIG..F14BCI_ERRCNT_PROCHOT order\n
+												  Default: -\n*/
+#define F14BC_BLK_SVEVENTS	M_DEV_BLK_OF+0x03    /**< G: get and remove pending supervision events\n
+											      Values: F14BC_SVEVENT[], blk.size is set to
+												  the size of the returned events\n
+												  Default: -\n*/
+#define F14BC_BLK_VOLT_HIST	M_DEV_BLK_OF+0x04    /**< G: input voltage statistics of all channels
+												  over the history window\n
+											      Values: F14BC_VOLT_STAT[F14BCI_VOLT_NBR]\n
+												  Default: -\n*/
+#define F14BC_BLK_BUSQ_STAT	M_DEV_BLK_OF+0x05    /**< G: SMBus queue statistics (*)\n
+											      Values: F14BC_BUSQ_STAT[F14BC_BUSQ_NBR]\n
+												  Default: -\n*/
+#define F14BC_BLK_XFER_STAT	M_DEV_BLK_OF+0x06    /**< G: SMBus transaction statistics (*)\n
+											      Values: F14BC_XFER_STAT\n
+												  Default: -\n*/
+#define F14BC_BLK_VOLT_CFG	M_DEV_BLK_OF+0x07    /**< S: set nominal/deviation voltages of all
+												  channels at once (F14BC_VOLT.in is ignored)\n
+											      Values: F14BC_VOLT[F14BCI_VOLT_NBR]\n
+												  Default: -\n*/
+#define F14BC_BLK_CTRL_SNAP	M_DEV_BLK_OF+0x08    /**< G: supervision state of all controllers
+												  from the last poll sweep (index 0: this
+												  F14BC, index n: CTRL_n)\n
+											      Values: F14BC_CTRL_SNAP[1+CTRL_NUMBER],
+												  blk.size is set to the returned size\n
+												  Default: -\n*/
+#define F14BC_BLK_MULTI		M_DEV_BLK_OF+0x09    /**< G: perform several getstats with one call (*)\n
+											      Values: F14BC_MULTI[], the number of
+												  requests is blk.size / sizeof(F14BC_MULTI)\n
+												  Default: -\n*/
 /**@}*/
 
 #ifndef  F14BC_VARIANT
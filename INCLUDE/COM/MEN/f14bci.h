@@ -85,6 +85,8 @@
 #define F14BCI_ERRCNT_RST_ACTIVE (0x74)	/**< counter: signal PLT_RST not deasserted (Br) */
 #define F14BCI_ERRCNT_TEMP		(0x75)	/**< counter: temperature emergency cutout (Br) */
 #define F14BCI_ERRCNT_PROCHOT	(0x76)	/**< counter: processor hot (Br) */
+#	define F14BCI_ERRCNT_NBR		(7)		/**< number of error counters
+												Note: 0x70..0x70+F14BCI_ERRCNT_NBR-1 */
 #define F14BCI_ERRCNT_CLR		(0x7a)	/**< clear all error counters (C) */
 
 #define F14BCI_GETREV(b)		(0x80+(b))	/**< firmware revision ascii character 0..5 (r*)